@@ -859,9 +859,10 @@ distmatT SCF::kinetic_energy_matrix(World & world, const vecfuncT & v) const {
 	reconstruct(world, v);
 	END_TIMER(world, "KEmat reconstruct");
 	START_TIMER(world);
-	vecfuncT dvx = apply(world, *(gradop[0]), v, false);
-	vecfuncT dvy = apply(world, *(gradop[1]), v, false);
-	vecfuncT dvz = apply(world, *(gradop[2]), v, false);
+	std::vector<vecfuncT> dv = GradientOperator<double,3>(gradop)(v, false);
+	vecfuncT& dvx = dv[0];
+	vecfuncT& dvy = dv[1];
+	vecfuncT& dvz = dv[2];
 	world.gop.fence();
 	END_TIMER(world, "KEmat differentiate");
 	START_TIMER(world);
@@ -888,12 +889,15 @@ distmatT SCF::kinetic_energy_matrix(World & world, const vecfuncT & vbra, const
 	distmatT r = column_distributed_matrix<double>(world, n, n);
 	reconstruct(world, vbra);
 	reconstruct(world, vket);
-	vecfuncT dvx_bra = apply(world, *(gradop[0]), vbra, false);
-	vecfuncT dvy_bra = apply(world, *(gradop[1]), vbra, false);
-	vecfuncT dvz_bra = apply(world, *(gradop[2]), vbra, false);
-	vecfuncT dvx_ket = apply(world, *(gradop[0]), vket, false);
-	vecfuncT dvy_ket = apply(world, *(gradop[1]), vket, false);
-	vecfuncT dvz_ket = apply(world, *(gradop[2]), vket, false);
+	GradientOperator<double,3> grad(gradop);
+	std::vector<vecfuncT> dv_bra = grad(vbra, false);
+	std::vector<vecfuncT> dv_ket = grad(vket, false);
+	vecfuncT& dvx_bra = dv_bra[0];
+	vecfuncT& dvy_bra = dv_bra[1];
+	vecfuncT& dvz_bra = dv_bra[2];
+	vecfuncT& dvx_ket = dv_ket[0];
+	vecfuncT& dvy_ket = dv_ket[1];
+	vecfuncT& dvz_ket = dv_ket[2];
 	world.gop.fence();
 	compress(world,dvx_bra,false);
 	compress(world,dvy_bra,false);
@@ -1736,7 +1740,8 @@ vecfuncT SCF::apply_potential(World & world, const tensorT & occ,
 	if (xc.hf_exchange_coefficient()) {
 		START_TIMER(world);
 		//            vecfuncT Kamo = apply_hf_exchange(world, occ, amo, amo);
-		Exchange<double,3> K=Exchange<double,3>(world,this,ispin).small_memory(false).same(true);
+		Exchange<double,3> K=Exchange<double,3>(world,this,ispin).small_memory(false).same(true)
+				.screened(param.do_localize());
 		vecfuncT Kamo=K(amo);
 		tensorT excv = inner(world, Kamo, amo);
 		double exchf = 0.0;
@@ -51,11 +51,8 @@ DistributedMatrix<T> Kinetic<T,NDIM>::kinetic_energy_matrix(World & world,
     DistributedMatrix<T> r = column_distributed_matrix<T>(world, n, n);
     reconstruct(world, v);
 
-    // apply the derivative operator on each function for each dimension
-    std::vector<vecfuncT> dv(NDIM);
-    for (std::size_t i=0; i<NDIM; ++i) {
-        dv[i]=apply(world, *(gradop[i]), v, false);
-    }
+    // differentiate each function along all dimensions in a single traversal
+    std::vector<vecfuncT> dv=GradientOperator<T,NDIM>(gradop)(v, false);
     world.gop.fence();
     for (std::size_t i=0; i<NDIM; ++i) {
         compress(world,dv[i],false);
@@ -79,12 +76,10 @@ DistributedMatrix<T> Kinetic<T,NDIM>::kinetic_energy_matrix(World & world,
     reconstruct(world, vket);
     const auto bra_equiv_ket = &vbra == &vket;
 
-    // apply the derivative operator on each function for each dimension
-    std::vector<vecfuncT> dvbra(NDIM),dvket(NDIM);
-    for (std::size_t i=0; i<NDIM; ++i) {
-        dvbra[i]=apply(world, *(gradop[i]), vbra, false);
-        dvket[i]=apply(world, *(gradop[i]), vket, false);
-    }
+    // differentiate each function along all dimensions in a single traversal
+    GradientOperator<T,NDIM> grad(gradop);
+    std::vector<vecfuncT> dvbra=grad(vbra, false);
+    std::vector<vecfuncT> dvket=grad(vket, false);
     world.gop.fence();
     for (std::size_t i=0; i<NDIM; ++i) {
         compress(world,dvbra[i],false);
@@ -299,7 +294,7 @@ vecfuncT DNuclear::operator()(const vecfuncT& vket) const {
 
 template<typename T, std::size_t NDIM>
 Exchange<T,NDIM>::Exchange(World& world, const SCF* calc, const int ispin)
-        : world(world), small_memory_(true), same_(false) {
+        : world(world), small_memory_(true), same_(false), screened_(false) {
     if (ispin==0) { // alpha spin
         mo_ket=convert<double,T,NDIM>(world,calc->amo);		// deep copy necessary if T==double_complex
         occ=calc->aocc;
@@ -349,9 +344,12 @@ std::vector<Function<T,NDIM> > Exchange<T,NDIM>::operator()(
         norm_tree(world, vket);
     }
 
-    if (small_memory_) {     // Smaller memory algorithm ... possible 2x saving using i-j sym
+    if (screened_) {
+        Kf = K_screened(vket, mul_tol);
+    } else if (small_memory_) {     // Smaller memory algorithm ... possible 2x saving using i-j sym
         for(int i=0; i<nocc; ++i){
             if(occ[i] > 0.0){
+                ValueCachedFunction<T,NDIM> bra(mo_bra[i]);
                 vecfuncT psif = mul_sparse(world, mo_bra[i], vket, mul_tol); /// was vtol
                 truncate(world, psif);
                 psif = apply(world, *poisson.get(), psif);
@@ -362,16 +360,20 @@ std::vector<Function<T,NDIM> > Exchange<T,NDIM>::operator()(
         }
     } else {    // Larger memory algorithm ... use i-j sym if psi==f
         vecfuncT psif;
+        std::vector< ValueCachedFunction<T,NDIM> > bra;   // values of mo_bra[i] are reused for all j
+        bra.reserve(nocc);
         for (int i = 0; i < nocc; ++i) {
             int jtop = nf;
             if (same)
                 jtop = i + 1;
+            bra.push_back(ValueCachedFunction<T,NDIM>(mo_bra[i]));
             for (int j = 0; j < jtop; ++j) {
                 psif.push_back(mul_sparse(mo_bra[i], vket[j], mul_tol, false));
             }
         }
 
         world.gop.fence();
+        bra.clear();
         truncate(world, psif,tol);
         psif = apply(world, *poisson.get(), psif);
         truncate(world, psif, tol);
@@ -408,6 +410,94 @@ std::vector<Function<T,NDIM> > Exchange<T,NDIM>::operator()(
 
 }
 
+/// pair-list exchange: only significant pair densities are passed to the Poisson solver
+
+/// For localized orbitals the number of pairs i,j whose supports overlap
+/// grows only linearly with the system size.  The pair densities are formed
+/// with sparse multiplications, which are cheap for distant pairs since their
+/// trees are screened at a coarse level.  Pairs whose weighted density norm
+/// is below the screening threshold are dropped, and the potentials of the
+/// surviving pairs are computed in one batched Poisson apply.  If the ket
+/// space is the bra space each pair potential is used for both ij and ji.
+/// Input functions must be reconstructed with a norm tree.
+template<typename T, std::size_t NDIM>
+std::vector<Function<T,NDIM> > Exchange<T,NDIM>::K_screened(
+        const std::vector<Function<T,NDIM> >& vket, const double& mul_tol) const {
+    const bool same = this->same();
+    const int nocc = mo_bra.size();
+    const int nf = vket.size();
+    const double tol = FunctionDefaults < 3 > ::get_thresh();
+    const double screen = (screening_threshold_ < 0.0) ? 0.01*tol : screening_threshold_;
+    const double mtol = (mul_tol > 0.0) ? mul_tol : screen;
+
+    // pair densities, reusing the values of each bra for all kets
+    std::vector<std::pair<int,int> > pairs;
+    vecfuncT psif;
+    {
+        std::vector< ValueCachedFunction<T,NDIM> > bra;
+        bra.reserve(nocc);
+        for (int i = 0; i < nocc; ++i) {
+            const int jtop = same ? i + 1 : nf;
+            bra.push_back(ValueCachedFunction<T,NDIM>(mo_bra[i]));
+            for (int j = 0; j < jtop; ++j) {
+                pairs.push_back(std::make_pair(i,j));
+                psif.push_back(mul_sparse(mo_bra[i], vket[j], mtol, false));
+            }
+        }
+        world.gop.fence();
+    }
+
+    // screen the pair list
+    std::vector<double> norms = norm2s(world, psif);
+    std::vector<std::pair<int,int> > significant;
+    vecfuncT rho;
+    for (std::size_t ij = 0; ij < pairs.size(); ++ij) {
+        const int i = pairs[ij].first;
+        const int j = pairs[ij].second;
+        double weight = std::abs(occ[i]);
+        if (same) weight = std::max(weight, std::abs(occ[j]));
+        if (weight*norms[ij] > screen) {
+            significant.push_back(pairs[ij]);
+            rho.push_back(psif[ij]);
+        }
+    }
+    psif.clear();
+
+    // one batched Poisson apply for all surviving pairs
+    truncate(world, rho, tol);
+    rho = apply(world, *poisson.get(), rho);
+    truncate(world, rho, tol);
+    reconstruct(world, rho);
+    norm_tree(world, rho);
+
+    // K ket_j += occ_i (bra_i ket_j) ket_i, and by symmetry K ket_i += occ_j (bra_j ket_i) ket_j
+    vecfuncT Kij;
+    std::vector<int> target;
+    std::vector<double> factor;
+    for (std::size_t ij = 0; ij < significant.size(); ++ij) {
+        const int i = significant[ij].first;
+        const int j = significant[ij].second;
+        Kij.push_back(mul_sparse(rho[ij], mo_ket[i], mul_tol, false));
+        target.push_back(j);
+        factor.push_back(occ[i]);
+        if (same && i != j) {
+            Kij.push_back(mul_sparse(rho[ij], mo_ket[j], mul_tol, false));
+            target.push_back(i);
+            factor.push_back(occ[j]);
+        }
+    }
+    world.gop.fence();
+    rho.clear();
+    compress(world, Kij);
+
+    vecfuncT Kf = zero_functions_compressed<T,NDIM>(world, nf);
+    for (std::size_t k = 0; k < Kij.size(); ++k) {
+        Kf[target[k]].gaxpy(1.0, Kij[k], factor[k], false);
+    }
+    world.gop.fence();
+    return Kf;
+}
+
 
 /// custom ctor with information about the XC functional
 XCOperator::XCOperator(World& world, std::string xc_data, const bool spin_polarized,
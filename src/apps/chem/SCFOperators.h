@@ -420,7 +420,7 @@ class Exchange {
 public:
 
     /// default ctor
-    Exchange(World& world) : world(world), small_memory_(true), same_(false) {};
+    Exchange(World& world) : world(world), small_memory_(true), same_(false), screened_(false) {};
 
     /// ctor with a conventional calculation
     Exchange(World& world, const SCF* calc, const int ispin);
@@ -489,11 +489,32 @@ public:
         return *this;
     }
 
+    /// use the pair-list algorithm, which pays off for localized orbitals
+    bool& screened() {return screened_;}
+    bool screened() const {return screened_;}
+    Exchange& screened(const bool flag) {
+        screened_=flag;
+        return *this;
+    }
+
+    /// pairs with occ*||bra_i ket_j|| below this are skipped; negative means 0.01*thresh
+    double& screening_threshold() {return screening_threshold_;}
+    double screening_threshold() const {return screening_threshold_;}
+    Exchange& screening_threshold(const double thresh) {
+        screening_threshold_=thresh;
+        return *this;
+    }
+
 private:
 
+    /// exchange with a screened pair list and a single batched Poisson apply
+    vecfuncT K_screened(const vecfuncT& vket, const double& mul_tol) const;
+
     World& world;
     bool small_memory_=true;
     bool same_=false;
+    bool screened_=false;
+    double screening_threshold_=-1.0;
     vecfuncT mo_bra, mo_ket;    ///< MOs for bra and ket
     Tensor<double> occ;
     std::shared_ptr<real_convolution_3d> poisson;
@@ -504,6 +504,12 @@ int test_exchange(World& world) {
     if (typeid(T)==typeid(double)) success+=exchange_anchor_test(world, K, thresh);
     if (success>0) return 1;
 
+    // same with the screened pair-list algorithm
+    K.screened(true);
+    if (typeid(T)==typeid(double)) success+=exchange_anchor_test(world, K, thresh);
+    K.screened(false);
+    if (success>0) return 1;
+
     if (!smalltest) {
     	// test hermiticity of the K operator
     	success=test_hermiticity<T,Exchange<T,3> ,3>(world, K, thresh);
@@ -251,6 +251,11 @@ namespace madness {
             if (neigh.is_invalid()) {
                 return Future<argT>(argT(neigh,coeffT(vk,f->get_tensor_args()))); // Zero bc
             }
+            else if (f->get_coeffs().probe(neigh)) {
+                // Local neighbor: no need to go through a message or task
+                const nodeT& node = f->get_coeffs().find(neigh).get()->second;
+                return Future<argT>(argT(neigh, node.has_coeff() ? node.coeff() : coeffT()));
+            }
             else {
                 Future<argT> result;
 		if (f->get_coeffs().is_local(neigh))
@@ -743,6 +748,125 @@ namespace madness {
     }
 
 
+    /// Gradient operator producing all NDIM derivatives in a single traversal
+
+    /// Holds one Derivative per axis (as returned by gradient_operator) but
+    /// drives all of them from one loop over the boxes of the input: the
+    /// center coefficients of a box are shared by all axes and a single task
+    /// per box, depending on all 2*NDIM neighbors, produces every component.
+    /// The vector version reconstructs all inputs with one fence and
+    /// differentiates them with one final fence.
+    ///
+    /// \code
+    /// GradientOperator<double,3> gradop(world);
+    /// std::vector<real_function_3d> df=gradop(f);                    // df[axis]
+    /// std::vector<std::vector<real_function_3d> > dv=gradop(vf);     // dv[axis][i]
+    /// \endcode
+    template <typename T, std::size_t NDIM>
+    class GradientOperator {
+        typedef Function<T,NDIM> functionT;
+        typedef std::vector<functionT> vecfuncT;
+        typedef FunctionImpl<T,NDIM> implT;
+        typedef typename DerivativeBase<T,NDIM>::argT argT;
+        typedef typename DerivativeBase<T,NDIM>::coeffT coeffT;
+        typedef typename DerivativeBase<T,NDIM>::nodeT nodeT;
+        typedef std::vector< std::shared_ptr< Derivative<T,NDIM> > > derivvecT;
+
+        derivvecT D;
+
+        /// Differentiates one box along all axes once its neighbors are available
+        static void do_diff_all(const derivvecT& D, const implT* f, const std::vector<implT*>& df,
+                                const Key<NDIM>& key, const argT& center,
+                                const std::vector< Future<argT> >& left,
+                                const std::vector< Future<argT> >& right) {
+            for (std::size_t d=0; d<NDIM; ++d) {
+                D[d]->do_diff1(f, df[d], key, left[d].get(), center, right[d].get());
+            }
+        }
+
+        /// Spawns the tasks differentiating f into df[0..NDIM-1] (no fence)
+        void diff_all(const implT* f, const std::vector<implT*>& df) const {
+            World& world = f->world;
+            typename implT::dcT::const_iterator end = f->get_coeffs().end();
+            for (typename implT::dcT::const_iterator it=f->get_coeffs().begin(); it!=end; ++it) {
+                const Key<NDIM>& key = it->first;
+                const nodeT& node = it->second;
+                if (node.has_coeff()) {
+                    std::vector< Future<argT> > left(NDIM), right(NDIM);
+                    for (std::size_t d=0; d<NDIM; ++d) {
+                        left[d] = D[d]->find_neighbor(f, key,-1);
+                        right[d]= D[d]->find_neighbor(f, key, 1);
+                    }
+                    world.taskq.add(&GradientOperator<T,NDIM>::do_diff_all, D, f, df, key,
+                                    argT(key,node.coeff()), left, right, TaskAttributes::hipri());
+                }
+                else {
+                    for (std::size_t d=0; d<NDIM; ++d) {
+                        df[d]->get_coeffs().replace(key,nodeT(coeffT(),true)); // Empty internal node
+                    }
+                }
+            }
+        }
+
+    public:
+        /// Constructs the derivatives for all axes (same arguments as gradient_operator)
+        GradientOperator(World& world,
+                         const BoundaryConditions<NDIM>& bc = FunctionDefaults<NDIM>::get_bc(),
+                         int k = FunctionDefaults<NDIM>::get_k())
+            : D(gradient_operator<T,NDIM>(world,bc,k)) {}
+
+        /// Wraps existing derivatives, e.g. those held by a calculation
+        GradientOperator(const derivvecT& D) : D(D) {
+            MADNESS_ASSERT(D.size()==NDIM);
+        }
+
+        /// Access to the derivative along \c axis, e.g. to select the ble or bspline variants
+        Derivative<T,NDIM>& operator[](std::size_t axis) {return *D[axis];}
+
+        /// Access to the derivative along \c axis
+        const Derivative<T,NDIM>& operator[](std::size_t axis) const {return *D[axis];}
+
+        /// Returns the NDIM derivatives of f
+
+        /// A compressed input is reconstructed, which always fences
+        vecfuncT operator()(const functionT& f, bool fence=true) const {
+            std::vector<vecfuncT> df=this->operator()(vecfuncT(1,f),fence);
+            vecfuncT result(NDIM);
+            for (std::size_t d=0; d<NDIM; ++d) result[d]=df[d][0];
+            return result;
+        }
+
+        /// Returns the derivatives of all functions in vf as result[axis][i]
+
+        /// Compressed inputs are reconstructed, which always fences
+        std::vector<vecfuncT> operator()(const vecfuncT& vf, bool fence=true) const {
+            std::vector<vecfuncT> result(NDIM,vecfuncT(vf.size()));
+            if (vf.size()==0) return result;
+            World& world = vf[0].world();
+
+            bool need_fence=false;
+            for (const functionT& f : vf) {
+                if (f.is_compressed()) {
+                    f.reconstruct(false);
+                    need_fence=true;
+                }
+            }
+            if (need_fence) world.gop.fence();
+
+            for (std::size_t i=0; i<vf.size(); ++i) {
+                std::vector<implT*> df(NDIM);
+                for (std::size_t d=0; d<NDIM; ++d) {
+                    result[d][i].set_impl(vf[i],false);
+                    df[d] = result[d][i].get_impl().get();
+                }
+                diff_all(vf[i].get_impl().get(), df);
+            }
+            if (fence) world.gop.fence();
+            return result;
+        }
+    };
+
+
     namespace archive {
         template <class Archive, class T, std::size_t NDIM>
         struct ArchiveLoadImpl<Archive,const DerivativeBase<T,NDIM>*> {
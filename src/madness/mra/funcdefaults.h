@@ -184,6 +184,7 @@ namespace madness {
         static bool debug;             ///< Controls output of debug info
         static bool truncate_on_project; ///< If true initial projection inserts at n-1 not n
         static bool apply_randomize;   ///< If true use randomization for load balancing in apply integral operator
+        static bool apply_aggregate;   ///< If true sum remote contributions of apply locally before sending them
         static bool project_randomize; ///< If true use randomization for load balancing in project/refine
         static BoundaryConditions<NDIM> bc; ///< Default boundary conditions
         static Tensor<double> cell ;   ///< cell[NDIM][2] Simulation cell, cell(0,0)=xlo, cell(0,1)=xhi, ...
@@ -349,6 +350,20 @@ namespace madness {
             apply_randomize=value;
         }
 
+        /// Gets the aggregation of remote contributions for integral operators flag
+        static bool get_apply_aggregate() {
+            return apply_aggregate;
+        }
+
+        /// Sets the aggregation of remote contributions for integral operators flag
+
+        /// If true, contributions of apply to boxes owned by other processes are
+        /// summed locally and sent as one message per box after all source boxes
+        /// have been processed, instead of one message per contribution.
+        static void set_apply_aggregate(bool value) {
+            apply_aggregate=value;
+        }
+
 
         /// Gets the random load balancing for projection flag
         static bool get_project_randomize() {
@@ -133,7 +133,7 @@ namespace madness {
         coeffT _coeffs; ///< The coefficients, if any
         double _norm_tree; ///< After norm_tree will contain norm of coefficients summed up tree
         bool _has_children; ///< True if there are children
-        coeffT buffer; ///< The coefficients, if any
+        coeffT buffer; ///< Contributions appended by accumulate, added to the coefficients in consolidate_buffer
 
     public:
         typedef WorldContainer<Key<NDIM> , FunctionNode<T, NDIM> > dcT; ///< Type of container holding the nodes
@@ -236,6 +236,11 @@ namespace madness {
             _coeffs.reduce_rank(eps);
         }
 
+        /// reduces the rank of the coefficients with the algorithm given in targs
+        void reduceRank(const TensorArgs& targs) {
+            _coeffs.reduce_rank(targs);
+        }
+
         /// Sets \c has_children attribute to value of \c flag.
         void set_has_children(bool flag) {
             _has_children = flag;
@@ -361,23 +366,16 @@ namespace madness {
             double cpu0=cpu_time();
             if (has_coeff()) {
 
-#if 1
-                coeff().add_SVD(t,args.thresh);
-                if (buffer.rank()<coeff().rank()) {
-                    if (buffer.has_data()) {
-                        buffer.add_SVD(coeff(),args.thresh);
-                    } else {
-                        buffer=copy(coeff());
-                    }
-                    coeff()=coeffT();
+                if (coeff().tensor_type()==TT_FULL) {
+                    coeff().add_SVD(t,args.thresh);
+                } else {
+                    // append only; the rank is reduced once per node in
+                    // consolidate_buffer, or here when the buffer holds more
+                    // terms than a full rank tensor would
+                    buffer+=t;
+                    if (buffer.rank()>max_buffer_rank(t)) buffer.reduce_rank(args);
                 }
 
-#else
-                // always do low rank
-                coeff().add_SVD(t,args.thresh);
-
-#endif
-
             } else {
                 // No coeff and no children means the node is newly
                 // created for this operation and therefore we must
@@ -395,7 +393,19 @@ namespace madness {
             return cpu1-cpu0;
         }
 
+        /// maximum rank of the accumulation buffer before it is reduced
+
+        /// beyond the rank of a full matrix (r >= k^(NDIM/2)) appending
+        /// terms costs more memory than the full tensor; tensor train cores
+        /// grow quadratically with the rank and are kept at r <= k
+        static long max_buffer_rank(const coeffT& t) {
+            if (t.tensor_type()==TT_TENSORTRAIN) return t.dim(0);
+            return std::pow(t.dim(0),NDIM/2);
+        }
+
+        /// add the accumulation buffer to the coefficients, reducing its rank first
         void consolidate_buffer(const TensorArgs& args) {
+            if (buffer.has_data()) buffer.reduce_rank(args);
             if ((coeff().has_data()) and (buffer.has_data())) {
                 coeff().add_SVD(buffer,args.thresh);
             } else if (buffer.has_data()) {
@@ -819,6 +829,19 @@ namespace madness {
         return s;
     }
 
+    /// Memoized values of a function for repeated multiplication, see ValueCachedFunction
+
+    /// Each process holds only the boxes it owns.  Values are stored at the
+    /// quadrature points of every box in which the function was multiplied,
+    /// including boxes below the leaves, so the same Tensor is returned to all
+    /// callers and must not be modified.
+    template <typename T, std::size_t NDIM>
+    struct FunctionValueCache {
+        typedef ConcurrentHashMap< Key<NDIM>, Tensor<T> > mapT;
+        mapT values;        ///< function values at the quadrature points of a box
+        mapT unfiltered;    ///< sum coefficients of the children of a box, as from unfilter
+    };
+
     /// FunctionImpl holds all Function state to facilitate shallow copy semantics
 
     /// Since Function assignment and copy constructors are shallow it
@@ -883,6 +906,12 @@ namespace madness {
 
         dcT coeffs; ///< The coefficients
 
+        std::weak_ptr< FunctionValueCache<T,NDIM> > value_cache; ///< Alive while a ValueCachedFunction exists
+
+        ConcurrentHashMap<keyT,tensorT> apply_staging; ///< Remote contributions of apply, summed per box (apply_aggregate)
+        std::atomic<std::size_t> apply_nmsg{0};  ///< Remote contributions sent by this process in the last apply
+        std::atomic<std::size_t> apply_nbyte{0}; ///< Bytes of coefficients sent by this process in the last apply
+
         // Disable the default copy constructor
         FunctionImpl(const FunctionImpl<T,NDIM>& p);
 
@@ -1779,16 +1808,72 @@ namespace madness {
         }
 
 
+        /// Enables memoization of the values used in multiplication
+
+        /// The cache lives as long as the returned pointer (or a copy of it)
+        /// exists; a cache that is still alive is shared rather than replaced.
+        std::shared_ptr< FunctionValueCache<T,NDIM> > enable_value_cache() {
+            std::shared_ptr< FunctionValueCache<T,NDIM> > cache = value_cache.lock();
+            if (!cache) {
+                cache.reset(new FunctionValueCache<T,NDIM>());
+                value_cache = cache;
+            }
+            return cache;
+        }
+
+        /// Function values at the quadrature points of \c key for multiplication
+
+        /// @param[in] key the box
+        /// @param[in] coeff the scaling coefficients of this function in \c key
+        /// @return the values, memoized if the value cache is enabled
+        Tensor<T> values_for_mul(const keyT& key, const Tensor<T>& coeff) const {
+            std::shared_ptr< FunctionValueCache<T,NDIM> > cache = value_cache.lock();
+            if (!cache) return coeffs2values(key, coeff);
+
+            typename FunctionValueCache<T,NDIM>::mapT::accessor acc;
+            if (cache->values.insert(acc, key)) acc->second = coeffs2values(key, coeff);
+            return acc->second;
+        }
+
+        /// Sum coefficients of the children of \c key for multiplication
+
+        /// @param[in] key the box
+        /// @param[in] coeff the scaling coefficients of this function in \c key
+        /// @return the unfiltered coefficients, memoized if the value cache is enabled
+        Tensor<T> unfilter_for_mul(const keyT& key, const Tensor<T>& coeff) const {
+            std::shared_ptr< FunctionValueCache<T,NDIM> > cache = value_cache.lock();
+            if (cache) {
+                typename FunctionValueCache<T,NDIM>::mapT::const_accessor acc;
+                if (cache->unfiltered.find(acc, key)) return acc->second;
+            }
+
+            Tensor<T> d(cdata.v2k);
+            d(cdata.s0) = coeff(___);
+            Tensor<T> ss = unfilter(d);
+
+            if (cache) {
+                typename FunctionValueCache<T,NDIM>::mapT::accessor acc;
+                if (!cache->unfiltered.insert(acc, key)) return acc->second; // Lost the race
+                acc->second = ss;
+            }
+            return ss;
+        }
+
         /// Functor for the mul method
         template <typename L, typename R>
         void do_mul(const keyT& key, const Tensor<L>& left, const std::pair< keyT, Tensor<R> >& arg) {
+            // PROFILE_MEMBER_FUNC(FunctionImpl); // Too fine grain for routine profiling
+            do_mul_values<L,R>(key, fcube_for_mul(key, key, left), arg);
+        }
+
+        /// Functor for the mul method given the values of the left function in \c key
+        template <typename L, typename R>
+        void do_mul_values(const keyT& key, const Tensor<L>& left, const std::pair< keyT, Tensor<R> >& arg) {
             // PROFILE_MEMBER_FUNC(FunctionImpl); // Too fine grain for routine profiling
             const keyT& rkey = arg.first;
             const Tensor<R>& rcoeff = arg.second;
-            //madness::print("do_mul: r", rkey, rcoeff.size());
             Tensor<R> rcube = fcube_for_mul(key, rkey, rcoeff);
-            //madness::print("do_mul: l", key, left.size());
-            Tensor<L> lcube = fcube_for_mul(key, key, left);
+            Tensor<L> lcube = left;     // Shallow copy, possibly shared with the value cache
 
             Tensor<T> tcube(cdata.vk,false);
             TERNARY_OPTIMIZED_ITERATOR(T, tcube, L, lcube, R, rcube, *_p0 = *_p1 * *_p2;);
@@ -2103,7 +2188,7 @@ namespace madness {
             bool operator()(typename rangeT::iterator& it) const {
 
                 nodeT& node = it->second;
-                node.reduceRank(args.thresh);
+                node.reduceRank(args);
                 return true;
             }
             template <typename Archive> void serialize(const Archive& ar) {}
@@ -2683,6 +2768,7 @@ namespace madness {
             std::vector<FunctionImpl<T,NDIM>*> vresult;
             std::vector<const FunctionImpl<R,NDIM>*> vright;
             std::vector< Tensor<R> > vrc;
+            Tensor<L> lcube;
             vresult.reserve(vrightin.size());
             vright.reserve(vrightin.size());
             vrc.reserve(vrightin.size());
@@ -2704,7 +2790,8 @@ namespace madness {
                 }
 
                 if (rc.size() && lc.size()) { // Yipee!
-                    result->task(world.rank(), &implT:: template do_mul<L,R>, key, lc, std::make_pair(key,rc));
+                    if (lcube.size() == 0) lcube = left->values_for_mul(key, lc); // Shared by all right functions
+                    result->task(world.rank(), &implT:: template do_mul_values<L,R>, key, lcube, std::make_pair(key,rc));
                 }
                 else if (tol && lnorm*rnorm < truncate_tol(tol, key)) {
                     result->coeffs.replace(key, nodeT(coeffT(cdata.vk,targs),false)); // Zero leaf
@@ -2719,11 +2806,7 @@ namespace madness {
 
             if (vresult.size()) {
                 Tensor<L> lss;
-                if (lc.size()) {
-                    Tensor<L> ld(cdata.v2k);
-                    ld(cdata.s0) = lc(___);
-                    lss = left->unfilter(ld);
-                }
+                if (lc.size()) lss = left->unfilter_for_mul(key, lc);
 
                 std::vector< Tensor<R> > vrss(vresult.size());
                 for (unsigned int i=0; i<vresult.size(); ++i) {
@@ -2793,7 +2876,7 @@ namespace madness {
 
             // both nodes are leaf nodes: multiply and return
             if (rc.size() && lc.size()) { // Yipee!
-                do_mul<L,R>(key, lc, std::make_pair(key,rc));
+                do_mul_values<L,R>(key, left->values_for_mul(key, lc), std::make_pair(key,rc));
                 return;
             }
 
@@ -2812,11 +2895,7 @@ namespace madness {
             coeffs.replace(key, nodeT(coeffT(),true)); // Interior node
 
             Tensor<L> lss;
-            if (lc.size()) {
-                Tensor<L> ld(cdata.v2k);
-                ld(cdata.s0) = lc(___);
-                lss = left->unfilter(ld);
-            }
+            if (lc.size()) lss = left->unfilter_for_mul(key, lc);
 
             Tensor<R> rss;
             if (rc.size()) {
@@ -4268,7 +4347,7 @@ namespace madness {
                     if (node.has_children()) {
                         // Zero out scaling coeffs
                         node.coeff()(impl->cdata.s0)=0.0;
-                        node.reduceRank(impl->targs.thresh);
+                        node.reduceRank(impl->targs);
                     } else {
                         // Deleting both scaling and wavelet coeffs
                         node.clear_coeff();
@@ -4347,7 +4426,8 @@ namespace madness {
                 small++;
                 //double cpu0=cpu_time();
                 coeffT result=coeffT(result_full,apply_targs);
-                MADNESS_ASSERT(result.tensor_type()==TT_FULL or result.tensor_type()==TT_2D);
+                MADNESS_ASSERT(result.tensor_type()==TT_FULL or result.tensor_type()==TT_2D
+                        or result.tensor_type()==TT_TENSORTRAIN);
                 //double cpu1=cpu_time();
                 //timer_lr_result.accumulate(cpu1-cpu0);
 
@@ -4384,7 +4464,8 @@ namespace madness {
                 small++;
 
                 double cpu0=cpu_time();
-                if (targs.tt!=result.tensor_type()) result=result.convert(targs);
+                if (apply_targs.tt!=result.tensor_type())
+                    result=result.convert(TensorArgs(targs.thresh,apply_targs.tt));
                 double cpu1=cpu_time();
                 timer_lr_result.accumulate(cpu1-cpu0);
 
@@ -4448,43 +4529,121 @@ namespace madness {
             //previously fac=10.0 selected empirically constrained by qmprop
 
             double cnorm = c.normf();
+            const double tol = truncate_tol(thresh, key);
 
             const std::vector<opkeyT>& disp = op->get_disp(key.level()); // list of displacements sorted in orer of increasing distance
+            const auto& shells = op->get_disp_shells(key.level()); // the same grouped in shells of equal distance
             const std::vector<bool> is_periodic(NDIM,false); // Periodic sum is already done when making rnlp
 	    int ndone=1;	// Counts #done at each distance
-	    uint64_t distsq = 99999999999999; 
-            for (typename std::vector<opkeyT>::const_iterator it=disp.begin(); it != disp.end(); ++it) {
+            Key<NDIM-opdim> nullkey(key.level());
+            for (const auto& shell : shells) {
+		if (ndone == 0 && shell.distsq > 1) {
+		    // Have at least done the input box and all first
+		    // nearest neighbors, and for all of the last set
+		    // of neighbors had no contribution.  Thus,
+		    // assuming monotonic decrease, we are done.
+		    break;
+		}
+		ndone = 0;
+
+		// no displacement of this shell contributes
+		if (cnorm*shell.maxnorm <= tol/fac) continue;
+
+              for (std::size_t i=shell.begin; i<shell.end; ++i) {
+                const opkeyT& disp_i=disp[i];
 	        keyT d;
-                Key<NDIM-opdim> nullkey(key.level());
-                if (op->particle()==1) d=it->merge_with(nullkey);
-                if (op->particle()==2) d=nullkey.merge_with(*it);
-
-		uint64_t dsq = d.distsq();
-		if (dsq != distsq) { // Moved to next shell of neighbors
-		    if (ndone == 0 && dsq > 1) {
-		        // Have at least done the input box and all first
-		        // nearest neighbors, and for all of the last set
-		        // of neighbors had no contribution.  Thus,
-		        // assuming monotonic decrease, we are done.
-		        break;
-		    }
-		    ndone = 0;
-		    distsq = dsq;
-		} 
+                if (op->particle()==1) d=disp_i.merge_with(nullkey);
+                if (op->particle()==2) d=nullkey.merge_with(disp_i);
 
                 keyT dest = neighbor(key, d, is_periodic);
                 if (dest.is_valid()) {
-                    double opnorm = op->norm(key.level(), *it, source);
-                    double tol = truncate_tol(thresh, key);
+                    double opnorm = op->norm(key.level(), disp_i, source);
 
                     if (cnorm*opnorm> tol/fac) {
 		        ndone++;
-		        tensorT result = op->apply(source, *it, c, tol/fac/cnorm);
-			if (result.normf() > 0.3*tol/fac) {
-			  if (coeffs.is_local(dest))
-			      coeffs.send(dest, &nodeT::accumulate2, result, coeffs, dest);
-			  else
-  			      coeffs.task(dest, &nodeT::accumulate2, result, coeffs, dest);
+		        tensorT result = op->apply(source, disp_i, c, tol/fac/cnorm);
+			if (result.normf() > 0.3*tol/fac) accumulate_apply_contribution(dest, result);
+                    }
+                }
+              }
+            }
+        }
+
+
+        /// apply an operator on the coeffs of several functions at the same node key
+
+        /// Same as do_apply, but for each displacement the coeffs of all functions
+        /// that contribute are transformed together.
+        /// @param[in] op	the operator to act on the source functions
+        /// @param[in] key	key of the source FunctionNodes which are processed
+        /// @param[in] c	coeffs of the FunctionNodes at key, one per function
+        /// @param[in] vresult	the functions the contributions of c are accumulated to
+        template <typename opT, typename R>
+        void do_apply_vector(const opT* op, const keyT& key, const std::vector< Tensor<R> >& c,
+                             const std::vector<implT*>& vresult) {
+            PROFILE_MEMBER_FUNC(FunctionImpl);
+            MADNESS_ASSERT(c.size()==vresult.size());
+
+            typedef typename opT::keyT opkeyT;
+            static const size_t opdim=opT::opdim;
+            const opkeyT source=op->get_source_key(key);
+
+            // see do_apply for the screening
+            double radius = 1.5 + 0.33*std::max(0.0,2-std::log10(thresh)-k);
+            double fac = vol_nsphere(NDIM, radius);
+
+            std::vector<double> cnorm(c.size());
+            std::vector<std::size_t> order(c.size());
+            for (std::size_t j=0; j<c.size(); ++j) {
+                cnorm[j]=c[j].normf();
+                order[j]=j;
+            }
+            std::sort(order.begin(), order.end(),
+                      [&cnorm] (std::size_t a, std::size_t b) {return cnorm[a]>cnorm[b];});
+            const double cnormmax=cnorm[order[0]];
+            const double tol = truncate_tol(thresh, key);
+
+            const std::vector<opkeyT>& disp = op->get_disp(key.level());
+            const auto& shells = op->get_disp_shells(key.level());
+            const std::vector<bool> is_periodic(NDIM,false);
+            int ndone=1;
+            Key<NDIM-opdim> nullkey(key.level());
+            std::vector< Tensor<R> > cbatch;
+            std::vector<implT*> rbatch;
+            for (const auto& shell : shells) {
+                if (ndone == 0 && shell.distsq > 1) break;
+                ndone = 0;
+                if (cnormmax*shell.maxnorm <= tol/fac) continue;
+
+                for (std::size_t i=shell.begin; i<shell.end; ++i) {
+                    const opkeyT& disp_i=disp[i];
+                    keyT d;
+                    if (op->particle()==1) d=disp_i.merge_with(nullkey);
+                    if (op->particle()==2) d=nullkey.merge_with(disp_i);
+
+                    keyT dest = neighbor(key, d, is_periodic);
+                    if (not dest.is_valid()) continue;
+                    double opnorm = op->norm(key.level(), disp_i, source);
+
+                    // the functions that contribute at this displacement, in batches
+                    // of similar norm, since the largest norm in a batch sets the
+                    // accuracy of the operator for all of them
+                    std::size_t jj=0;
+                    while (jj<order.size() and cnorm[order[jj]]*opnorm > tol/fac) {
+                        const double batchnorm=cnorm[order[jj]];
+                        cbatch.clear();
+                        rbatch.clear();
+                        for (; jj<order.size() and cnorm[order[jj]]*opnorm > tol/fac
+                                and cnorm[order[jj]] > 0.1*batchnorm; ++jj) {
+                            cbatch.push_back(c[order[jj]]);
+                            rbatch.push_back(vresult[order[jj]]);
+                        }
+                        ndone++;
+
+                        std::vector<tensorT> result = op->apply(source, disp_i, cbatch, tol/fac/batchnorm);
+                        for (std::size_t j=0; j<result.size(); ++j) {
+                            if (result[j].normf() > 0.3*tol/fac)
+                                rbatch[j]->accumulate_apply_contribution(dest, result[j]);
                         }
                     }
                 }
@@ -4492,11 +4651,58 @@ namespace madness {
         }
 
 
+        /// accumulate a contribution of do_apply into the box dest of this
+        void accumulate_apply_contribution(const keyT& dest, const tensorT& result) {
+            if (coeffs.is_local(dest))
+                coeffs.send(dest, &nodeT::accumulate2, result, coeffs, dest);
+            else if (FunctionDefaults<NDIM>::get_apply_aggregate())
+                stage_apply_contribution(dest, result);
+            else
+                send_apply_contribution(dest, result);
+        }
+
+
+        /// sum a contribution of do_apply to a remote box into the staging map
+        void stage_apply_contribution(const keyT& dest, const tensorT& result) {
+            typename ConcurrentHashMap<keyT,tensorT>::accessor acc;
+            if (apply_staging.insert(acc,dest)) acc->second=result;
+            else acc->second+=result;
+        }
+
+        /// send a contribution of do_apply to its remote box and count the message
+        void send_apply_contribution(const keyT& dest, const tensorT& result) {
+            apply_nmsg++;
+            apply_nbyte+=result.size()*sizeof(T);
+            coeffs.task(dest, &nodeT::accumulate2, result, coeffs, dest);
+        }
+
+        /// send the staged contributions of apply, one message per box
+
+        /// must be called after all do_apply tasks of this process have finished
+        void flush_apply_staging() {
+            typename ConcurrentHashMap<keyT,tensorT>::iterator end=apply_staging.end();
+            for (typename ConcurrentHashMap<keyT,tensorT>::iterator it=apply_staging.begin(); it!=end; ++it) {
+                send_apply_contribution(it->first, it->second);
+            }
+            apply_staging.clear();
+        }
+
+        /// number of remote contributions sent by this process in the last apply
+        std::size_t get_apply_nmsg() const {return apply_nmsg;}
+
+        /// bytes of coefficients sent to remote boxes by this process in the last apply
+        std::size_t get_apply_nbyte() const {return apply_nbyte;}
+
         /// apply an operator on f to return this
+
+        /// With FunctionDefaults::apply_aggregate the remote contributions are
+        /// staged and sent after a fence, which is therefore always done.
         template <typename opT, typename R>
         void apply(opT& op, const FunctionImpl<R,NDIM>& f, bool fence) {
             PROFILE_MEMBER_FUNC(FunctionImpl);
             MADNESS_ASSERT(!op.modified());
+            apply_nmsg=0;
+            apply_nbyte=0;
             typename dcT::const_iterator end = f.coeffs.end();
             for (typename dcT::const_iterator it=f.coeffs.begin(); it!=end; ++it) {
                 // looping through all the coefficients in the source
@@ -4510,6 +4716,10 @@ namespace madness {
                     }
                 }
             }
+            if (FunctionDefaults<NDIM>::get_apply_aggregate()) {
+                world.gop.fence();
+                flush_apply_staging();
+            }
             if (fence)
                 world.gop.fence();
 
@@ -4519,6 +4729,59 @@ namespace madness {
 
         }
 
+        /// apply an operator on the functions vf to return the functions vresult
+
+        /// The source boxes of all functions with the same key are processed by one
+        /// task, see do_apply_vector. This may be any of vresult.
+        /// @param[in] op	the operator to act on the source functions
+        /// @param[in] vf	the source functions in nonstandard form
+        /// @param[in] vresult	the result functions, one per source function
+        /// @param[in] fence	fence after the application
+        template <typename opT, typename R>
+        void apply_vector(opT& op, const std::vector<const FunctionImpl<R,NDIM>*>& vf,
+                          const std::vector<implT*>& vresult, bool fence) {
+            PROFILE_MEMBER_FUNC(FunctionImpl);
+            MADNESS_ASSERT(!op.modified());
+            MADNESS_ASSERT(vf.size()==vresult.size());
+            for (implT* r : vresult) {
+                r->apply_nmsg=0;
+                r->apply_nbyte=0;
+            }
+
+            // collect the local source boxes of all functions by key
+            typedef std::pair< std::vector< Tensor<R> >, std::vector<implT*> > batchT;
+            std::map<keyT,batchT> batches;
+            for (std::size_t i=0; i<vf.size(); ++i) {
+                typedef typename FunctionImpl<R,NDIM>::dcT::const_iterator citerT;
+                citerT end = vf[i]->coeffs.end();
+                for (citerT it=vf[i]->coeffs.begin(); it!=end; ++it) {
+                    const FunctionNode<R,NDIM>& node = it->second;
+                    if (node.has_coeff() and (node.coeff().dim(0) != k || op.doleaves)) {
+                        batchT& batch=batches[it->first];
+                        batch.first.push_back(node.coeff().reconstruct_tensor());
+                        batch.second.push_back(vresult[i]);
+                    }
+                }
+            }
+            for (const auto& kb : batches) {
+                world.taskq.add(*this, &implT:: template do_apply_vector<opT,R>, &op, kb.first,
+                                kb.second.first, kb.second.second);
+            }
+
+            if (FunctionDefaults<NDIM>::get_apply_aggregate()) {
+                world.gop.fence();
+                for (implT* r : vresult) r->flush_apply_staging();
+            }
+            if (fence)
+                world.gop.fence();
+
+            for (implT* r : vresult) {
+                r->compressed=true;
+                r->nonstandard=true;
+                r->redundant=false;
+            }
+        }
+
 
 
         /// apply an operator on the coeffs c (at node key)
@@ -4555,6 +4818,10 @@ namespace madness {
             TensorArgs apply_targs(targs);
             apply_targs.thresh=tol/fac*0.03;
 
+            // contributions to tensor train nodes are summed in SVD form and
+            // converted once per node in finalize_apply (do_change_tensor_type)
+            if (apply_targs.tt==TT_TENSORTRAIN) apply_targs.tt=TT_2D;
+
             double maxnorm=0.0;
 
             // for the kernel it may be more efficient to do the convolution in full rank
@@ -4618,7 +4885,9 @@ namespace madness {
                                 if (not coeff_full.has_data()) coeff_full=coeff.full_tensor_copy();
                                 norm=do_apply_kernel2(op, coeff_full,args,apply_targs);
                             } else {
-                                if (2*opdim==NDIM) {    // apply operator on one particle only
+                                // the operator works on the SVD form, so tensor trains are
+                                // only applied in their two-mode representation
+                                if (2*opdim==NDIM or coeff.tensor_type()!=TT_2D) {
                                     norm=do_apply_kernel3(op,coeff_SVD,args,apply_targs);
                                 } else {
                                     norm=do_apply_kernel3(op,coeff,args,apply_targs);
@@ -5262,6 +5531,90 @@ namespace madness {
             return r;
         }
 
+        /// Computes the local contribution to one tile of the matrix of inner products
+
+        /// Tile (i,j) with \c ilo<=i<=ihi and \c jlo<=j<=jhi of the sparse
+        /// product \c Rij = sum(k) Aki * Bkj, using key maps from
+        /// make_key_vec_map.  For each common key the coefficients of all
+        /// functions in the tile range are packed into contiguous panels and
+        /// contracted with a single matrix multiply.  Local work only.
+        template <typename R>
+        static void do_inner_local_tileX(const typename mapT::iterator lstart,
+                                         const typename mapT::iterator lend,
+                                         typename FunctionImpl<R,NDIM>::mapT* rmap_ptr,
+                                         const long ilo, const long ihi,
+                                         const long jlo, const long jhi,
+                                         Tensor< TENSOR_RESULT_TYPE(T,R) >* result_ptr,
+                                         Mutex* mutex) {
+            typedef TENSOR_RESULT_TYPE(T,R) resultT;
+            Tensor<resultT> tile(ihi-ilo+1, jhi-jlo+1);
+            std::vector< std::pair<int,const coeffT*> > lv;
+            std::vector< std::pair<int,const typename FunctionImpl<R,NDIM>::coeffT*> > rv;
+            for (typename mapT::iterator lit=lstart; lit!=lend; ++lit) {
+                const keyT& key = lit->first;
+                typename FunctionImpl<R,NDIM>::mapT::iterator rit=rmap_ptr->find(key);
+                if (rit == rmap_ptr->end()) continue;
+
+                lv.clear();
+                rv.clear();
+                for (const auto& p : lit->second) if (p.first>=ilo && p.first<=ihi) lv.push_back(p);
+                for (const auto& p : rit->second) if (p.first>=jlo && p.first<=jhi) rv.push_back(p);
+                const long nleft = lv.size();
+                const long nright= rv.size();
+                if (nleft==0 || nright==0) continue;
+
+#if HAVE_GENTENSOR
+                for (long iv=0; iv<nleft; ++iv) {
+                    for (long jv=0; jv<nright; ++jv) {
+                        tile(lv[iv].first-ilo, rv[jv].first-jlo) += lv[iv].second->trace_conj(*(rv[jv].second));
+                    }
+                }
+#else
+                const long size = lv[0].second->size();
+                Tensor<T> Left(nleft, size);
+                Tensor<R> Right(nright, size);
+                Tensor<resultT> r(nleft, nright);
+                for (long iv=0; iv<nleft; ++iv) Left(iv,_) = *(lv[iv].second);
+                for (long jv=0; jv<nright; ++jv) Right(jv,_) = *(rv[jv].second);
+                if (TensorTypeData<T>::iscomplex) Left = Left.conj();
+                mxmT(nleft, nright, size, r.ptr(), Left.ptr(), Right.ptr());
+                for (long iv=0; iv<nleft; ++iv) {
+                    const long i = lv[iv].first-ilo;
+                    for (long jv=0; jv<nright; ++jv) tile(i, rv[jv].first-jlo) += r(iv,jv);
+                }
+#endif
+            }
+            mutex->lock();
+            *result_ptr += tile;
+            mutex->unlock();
+        }
+
+        /// Local contribution to tile [ilo:ihi,jlo:jhi] of the matrix of inner products
+
+        /// The key maps are built once by the caller (make_key_vec_map) and
+        /// may be shared between all tiles; \c rmap may be the same object as
+        /// \c lmap.  Returns the tile, which is not summed over processes.
+        template <typename R>
+        static Tensor< TENSOR_RESULT_TYPE(T,R) >
+        inner_local_tile(World& world, mapT& lmap, typename FunctionImpl<R,NDIM>::mapT& rmap,
+                         const long ilo, const long ihi, const long jlo, const long jhi) {
+            Tensor< TENSOR_RESULT_TYPE(T,R) > r(std::max(ihi-ilo+1,0l), std::max(jhi-jlo+1,0l));
+            if (r.size()==0 || lmap.size()==0) return r;
+
+            size_t chunk = (lmap.size()-1)/(3*4*5)+1;
+            Mutex mutex;
+            typename mapT::iterator lstart=lmap.begin();
+            while (lstart != lmap.end()) {
+                typename mapT::iterator lend = lstart;
+                advance(lend,chunk);
+                world.taskq.add(&FunctionImpl<T,NDIM>::do_inner_local_tileX<R>, lstart, lend, &rmap,
+                                ilo, ihi, jlo, jhi, &r, &mutex);
+                lstart = lend;
+            }
+            world.taskq.fence();
+            return r;
+        }
+
         /// Return the inner product with an external function on a specified function node.
         /// @param[in] key Key of the function node to compute the inner product on. (the domain of integration)
         /// @param[in] c Tensor of coefficients for the function at the function node given by key
@@ -5661,7 +6014,8 @@ namespace madness {
 
                 MADNESS_ASSERT(fimpl->get_coeffs().probe(key));		// must be local!
                 const nodeT& fnode=fimpl->get_coeffs().find(key).get()->second;
-                const coeffT& fcoeff=fnode.coeff();
+                const coeffT fcoeff=(fnode.coeff().tensor_type()==TT_TENSORTRAIN)
+                        ? fnode.coeff().convert(TensorArgs(-1.0,TT_2D)) : fnode.coeff();
 
                 // fast return if possible
                 if (fcoeff.has_no_data() or gcoeff.has_no_data())
@@ -5785,9 +6139,13 @@ namespace madness {
         /// @param[in]  dest    destination node for the result
         /// @param[in]  dim     which dimensions should be contracted: 0..LDIM-1 or LDIM..NDIM+LDIM-1
         template<size_t LDIM>
-        void do_project_out(const coeffT& fcoeff, const std::pair<keyT,coeffT> gpair, const keyT& gkey,
+        void do_project_out(const coeffT& fcoeff1, const std::pair<keyT,coeffT> gpair, const keyT& gkey,
                             const Key<NDIM>& dest, const int dim) const {
 
+            // contraction is done on the singular vectors of the SVD form
+            const coeffT fcoeff=(fcoeff1.tensor_type()==TT_TENSORTRAIN)
+                    ? fcoeff1.convert(TensorArgs(-1.0,TT_2D)) : fcoeff1;
+
             const coeffT gcoeff=parent_to_child(gpair.second,gpair.first,gkey);
 
             // fast return if possible
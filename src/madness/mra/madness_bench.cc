@@ -0,0 +1,515 @@
+/*
+  This file is part of MADNESS.
+
+  Copyright (C) 2007,2010 Oak Ridge National Laboratory
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+  For more information please contact:
+
+  Robert J. Harrison
+  Oak Ridge National Laboratory
+  One Bethel Valley Road
+  P.O. Box 2008, MS-6367
+
+  email: harrisonrj@ornl.gov
+  tel:   865-241-3937
+  fax:   865-572-0680
+*/
+
+/// \file madness_bench.cc
+/// \brief Timing harness for the core MRA kernels
+
+/// Times project, compress, reconstruct, truncate, multiply, operator
+/// apply (Coulomb in 3D, BSH otherwise), derivative, matrix_inner,
+/// transform and the operator apply on nfunc functions at once
+/// (vector_apply) for a set of dimensions and writes the results as JSON,
+/// one result per line so that the output can be diffed and parsed
+/// without a JSON library.
+///
+/// Usage (all arguments optional, key=value):
+/// \code
+///   madness_bench ndim=1,2,3 k=8 thresh=1.e-6 nfunc=20 nrep=3 \
+///                 ops=project,compress output=bench.json \
+///                 baseline=old.json tolerance=0.1
+/// \endcode
+///
+/// With \c baseline=file the timings are compared to a previously saved
+/// output; the program returns a nonzero exit code if any kernel is
+/// slower than the baseline by more than \c tolerance (relative).
+///
+/// GFLOP/s are estimated from the node counts of the resulting trees
+/// using the operation count of the dominant dense transforms; they are
+/// meant for comparing runs, not as an absolute hardware measure.
+
+#define NO_GENTENSOR
+#include <madness/mra/mra.h>
+#include <madness/mra/vmra.h>
+#include <madness/mra/operator.h>
+#include <madness/misc/ran.h>
+#include <sys/resource.h>
+#include <fstream>
+#include <sstream>
+#include <map>
+
+using namespace madness;
+
+namespace {
+
+    const double PI = 3.1415926535897932384;
+
+    /// Benchmark parameters, set from the command line
+    struct BenchParameters {
+        std::vector<int> ndims = {3};
+        int k = 8;
+        double thresh = 1.e-6;
+        double L = 20.0;
+        int nfunc = 20;
+        int nrep = 3;
+        std::vector<std::string> ops;
+        std::string output;
+        std::string baseline;
+        double tolerance = 0.10;
+
+        bool do_op(const std::string& name) const {
+            if (ops.empty()) return true;
+            return std::find(ops.begin(),ops.end(),name)!=ops.end();
+        }
+    };
+
+    /// Timing and size data for one kernel
+    struct BenchResult {
+        std::string name;
+        int ndim = 0;
+        int k = 0;
+        double thresh = 0.0;
+        double wall = 0.0;          ///< best wall time over all repetitions (s)
+        double cpu = 0.0;           ///< cpu time of the best repetition (s)
+        double flops = 0.0;         ///< estimated flop count of one repetition
+        std::size_t nodes = 0;      ///< total number of nodes of the result
+        std::size_t max_depth = 0;  ///< maximum depth of the result tree
+        double mem_hwm = 0.0;       ///< max over ranks of the resident set high-water mark (MiB)
+        std::size_t nmsg = 0;       ///< remote contributions sent by all ranks (apply only)
+        std::size_t nbyte = 0;      ///< bytes of coefficients sent by all ranks (apply only)
+
+        double gflops() const {
+            return (wall>0.0) ? flops/wall*1.e-9 : 0.0;
+        }
+
+        /// unique key for baseline comparison
+        std::string tag() const {
+            std::ostringstream s;
+            s << name << ":" << ndim << ":" << k << ":" << thresh;
+            return s.str();
+        }
+    };
+
+    std::vector<std::string> split(const std::string& s, char sep) {
+        std::vector<std::string> result;
+        std::stringstream ss(s);
+        std::string item;
+        while (std::getline(ss,item,sep)) if (item.size()) result.push_back(item);
+        return result;
+    }
+
+    /// resident set high-water mark of this process in MiB
+    double memory_high_water() {
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF,&usage)!=0) return 0.0;
+        return double(usage.ru_maxrss)/1024.0;    // kB on Linux
+    }
+
+    template <std::size_t NDIM>
+    class BenchGaussian : public FunctionFunctorInterface<double,NDIM> {
+    public:
+        typedef Vector<double,NDIM> coordT;
+        const coordT center;
+        const double exponent;
+        const double coefficient;
+
+        BenchGaussian(const coordT& center, double exponent)
+            : center(center), exponent(exponent)
+            , coefficient(pow(2.0*exponent/PI,0.25*NDIM)) {}
+
+        double operator()(const coordT& x) const {
+            double sum = 0.0;
+            for (std::size_t i=0; i<NDIM; ++i) {
+                double xx = center[i]-x[i];
+                sum += xx*xx;
+            };
+            return coefficient*exp(-exponent*sum);
+        }
+    };
+
+    /// Gaussians with reproducible centers and exponents so repeated runs build identical trees
+    template <std::size_t NDIM>
+    std::shared_ptr< FunctionFunctorInterface<double,NDIM> > make_gaussian(int i, double L) {
+        Vector<double,NDIM> center;
+        for (std::size_t d=0; d<NDIM; ++d) center[d]=0.1*L*sin(1.7*(i+1)*(d+1));
+        const double expnt=0.5+1.5*(i%7);
+        return std::shared_ptr< FunctionFunctorInterface<double,NDIM> >(new BenchGaussian<NDIM>(center,expnt));
+    }
+
+    /// Runs \c setup (untimed) and \c op nrep times and keeps the fastest repetition
+    template <typename setupT, typename opT>
+    BenchResult time_kernel(World& world, const std::string& name, int ndim,
+            const BenchParameters& param, setupT setup, opT op) {
+        BenchResult result;
+        result.name=name;
+        result.ndim=ndim;
+        result.k=param.k;
+        result.thresh=param.thresh;
+        result.wall=1.e100;
+        for (int irep=0; irep<param.nrep; ++irep) {
+            setup();
+            world.gop.fence();
+            double wall0=wall_time(), cpu0=cpu_time();
+            op();
+            world.gop.fence();
+            double wall=wall_time()-wall0, cpu=cpu_time()-cpu0;
+            if (wall<result.wall) {
+                result.wall=wall;
+                result.cpu=cpu;
+            }
+        }
+        world.gop.max(result.wall);
+        world.gop.max(result.cpu);
+        result.mem_hwm=memory_high_water();
+        world.gop.max(result.mem_hwm);
+        return result;
+    }
+
+    template <typename opT>
+    BenchResult time_kernel(World& world, const std::string& name, int ndim,
+            const BenchParameters& param, opT op) {
+        return time_kernel(world,name,ndim,param,[] () {},op);
+    }
+
+    /// Operator used for the apply benchmark: Coulomb in 3D, BSH otherwise
+    template <std::size_t NDIM>
+    std::shared_ptr< SeparatedConvolution<double,NDIM> > make_apply_operator(World& world, double thresh) {
+        const double lo=1.e-4;
+        return std::shared_ptr< SeparatedConvolution<double,NDIM> >(BSHOperatorPtr<NDIM>(world,1.0,lo,thresh));
+    }
+
+    template <>
+    std::shared_ptr< SeparatedConvolution<double,3> > make_apply_operator<3>(World& world, double thresh) {
+        const double lo=1.e-4;
+        return std::shared_ptr< SeparatedConvolution<double,3> >(CoulombOperatorPtr(world,lo,thresh));
+    }
+
+    template <std::size_t NDIM>
+    void run_benchmarks(World& world, const BenchParameters& param, std::vector<BenchResult>& results) {
+        typedef Function<double,NDIM> functionT;
+        typedef std::vector<functionT> vecfuncT;
+
+        FunctionDefaults<NDIM>::set_k(param.k);
+        FunctionDefaults<NDIM>::set_thresh(param.thresh);
+        FunctionDefaults<NDIM>::set_cubic_cell(-param.L/2,param.L/2);
+        FunctionDefaults<NDIM>::set_refine(true);
+        FunctionDefaults<NDIM>::set_initial_level(2);
+        FunctionDefaults<NDIM>::set_truncate_mode(1);
+
+        const double k=param.k;
+        const double d=NDIM;
+        const double kd=std::pow(k,d);
+        const double k2d=std::pow(2.0*k,d);
+
+        functionT f, g;
+        auto project=[&] () {
+            f=FunctionFactory<double,NDIM>(world).functor(make_gaussian<NDIM>(0,param.L));
+            g=FunctionFactory<double,NDIM>(world).functor(make_gaussian<NDIM>(1,param.L)).fence();
+        };
+        BenchResult rproject=time_kernel(world,"project",NDIM,param,project);
+        rproject.nodes=f.tree_size()+g.tree_size();
+        rproject.max_depth=std::max(f.max_depth(),g.max_depth());
+        // quadrature to coefficients, one transform per dimension
+        rproject.flops=rproject.nodes*2.0*d*k*kd;
+        if (param.do_op("project")) results.push_back(rproject);
+
+        if (param.do_op("compress") or param.do_op("reconstruct")) {
+            BenchResult rc=time_kernel(world,"compress",NDIM,param,
+                    [&] () {f.reconstruct();},
+                    [&] () {f.compress();});
+            BenchResult rr=time_kernel(world,"reconstruct",NDIM,param,
+                    [&] () {f.compress();},
+                    [&] () {f.reconstruct();});
+            // a two-scale filter of a (2k)^d tensor per parent node
+            const double nparent=f.tree_size()/std::pow(2.0,d);
+            rc.flops=rr.flops=nparent*2.0*d*2.0*k*k2d;
+            rc.nodes=rr.nodes=f.tree_size();
+            rc.max_depth=rr.max_depth=f.max_depth();
+            if (param.do_op("compress")) results.push_back(rc);
+            if (param.do_op("reconstruct")) results.push_back(rr);
+        }
+
+        if (param.do_op("truncate")) {
+            functionT t;
+            BenchResult r=time_kernel(world,"truncate",NDIM,param,
+                    [&] () {t=copy(f);},
+                    [&] () {t.truncate();});
+            r.nodes=t.tree_size();
+            r.max_depth=t.max_depth();
+            r.flops=f.tree_size()*2.0*kd;
+            results.push_back(r);
+        }
+
+        if (param.do_op("multiply")) {
+            functionT fg;
+            f.reconstruct();
+            g.reconstruct();
+            BenchResult r=time_kernel(world,"multiply",NDIM,param,[&] () {
+                fg=f*g;
+            });
+            r.nodes=fg.tree_size();
+            r.max_depth=fg.max_depth();
+            // two transforms to values and one back per result node
+            r.flops=r.nodes*3.0*2.0*d*k*kd;
+            results.push_back(r);
+        }
+
+        if (param.do_op("apply")) {
+            std::shared_ptr< SeparatedConvolution<double,NDIM> > op=make_apply_operator<NDIM>(world,param.thresh);
+            const std::string name=(NDIM==3) ? "apply_coulomb" : "apply_bsh";
+            // plain and with remote contributions summed per box before sending
+            for (bool aggregate : {false, true}) {
+                FunctionDefaults<NDIM>::set_apply_aggregate(aggregate);
+                functionT result;
+                BenchResult r=time_kernel(world,aggregate ? name+"_agg" : name,NDIM,param,[&] () {
+                    result=apply(*op,f);
+                });
+                r.nodes=result.tree_size();
+                r.max_depth=result.max_depth();
+                // counters of the last repetition
+                r.nmsg=result.get_impl()->get_apply_nmsg();
+                r.nbyte=result.get_impl()->get_apply_nbyte();
+                world.gop.sum(r.nmsg);
+                world.gop.sum(r.nbyte);
+                // no flop estimate: the work depends on the screening of the operator
+                results.push_back(r);
+            }
+            FunctionDefaults<NDIM>::set_apply_aggregate(false);
+        }
+
+        if (param.do_op("derivative")) {
+            Derivative<double,NDIM> D=free_space_derivative<double,NDIM>(world,0);
+            functionT df;
+            f.reconstruct();
+            BenchResult r=time_kernel(world,"derivative",NDIM,param,[&] () {
+                df=D(f);
+            });
+            r.nodes=df.tree_size();
+            r.max_depth=df.max_depth();
+            // three neighbor blocks transformed along one axis
+            r.flops=r.nodes*3.0*2.0*k*kd;
+            results.push_back(r);
+        }
+
+        if (param.do_op("matrix_inner") or param.do_op("transform") or param.do_op("vector_apply")) {
+            vecfuncT v(param.nfunc);
+            for (int i=0; i<param.nfunc; ++i) {
+                v[i]=FunctionFactory<double,NDIM>(world).functor(make_gaussian<NDIM>(i,param.L)).nofence();
+            }
+            world.gop.fence();
+            compress(world,v);
+            std::size_t ncoeff=0;
+            for (const functionT& vi : v) ncoeff+=vi.size();
+            const double n=param.nfunc;
+
+            if (param.do_op("matrix_inner")) {
+                Tensor<double> S;
+                BenchResult r=time_kernel(world,"matrix_inner",NDIM,param,[&] () {
+                    S=matrix_inner(world,v,v,true);
+                });
+                r.nodes=ncoeff/std::size_t(kd);
+                r.flops=2.0*n*ncoeff;
+                results.push_back(r);
+            }
+
+            if (param.do_op("transform")) {
+                Tensor<double> c(param.nfunc,param.nfunc);
+                for (int i=0; i<param.nfunc; ++i)
+                    for (int j=0; j<param.nfunc; ++j) c(i,j)=1.0/(1.0+std::abs(i-j));
+                vecfuncT w;
+                BenchResult r=time_kernel(world,"transform",NDIM,param,[&] () {
+                    w=transform(world,v,c);
+                });
+                r.nodes=0;
+                for (const functionT& wi : w) r.nodes+=wi.tree_size();
+                r.flops=2.0*n*ncoeff;
+                results.push_back(r);
+            }
+
+            if (param.do_op("vector_apply")) {
+                std::shared_ptr< SeparatedConvolution<double,NDIM> > op=make_apply_operator<NDIM>(world,param.thresh);
+                vecfuncT w;
+                BenchResult r=time_kernel(world,"vector_apply",NDIM,param,[&] () {
+                    w=apply(world,*op,v);
+                });
+                r.nodes=0;
+                for (const functionT& wi : w) r.nodes+=wi.tree_size();
+                results.push_back(r);
+            }
+        }
+    }
+
+    void write_json(std::ostream& s, World& world, const BenchParameters& param,
+            const std::vector<BenchResult>& results) {
+        s << "{\n";
+        s << "\"madness_bench\": {\"version\": 1, \"nproc\": " << world.size()
+          << ", \"nthread\": " << ThreadPool::size()+1 << "},\n";
+        s << "\"results\": [\n";
+        for (std::size_t i=0; i<results.size(); ++i) {
+            const BenchResult& r=results[i];
+            char buf[512];
+            snprintf(buf,sizeof(buf),"{\"name\": \"%s\", \"ndim\": %d, \"k\": %d, \"thresh\": %.3e, "
+                    "\"wall\": %.6e, \"cpu\": %.6e, \"gflops\": %.4f, \"nodes\": %zu, "
+                    "\"max_depth\": %zu, \"mem_hwm_mb\": %.1f, \"messages\": %zu, \"bytes\": %zu}",
+                    r.name.c_str(),r.ndim,r.k,r.thresh,r.wall,r.cpu,r.gflops(),
+                    r.nodes,r.max_depth,r.mem_hwm,r.nmsg,r.nbyte);
+            s << buf << ((i+1<results.size()) ? ",\n" : "\n");
+        }
+        s << "]\n}\n";
+    }
+
+    /// extracts the value of \c "key": from a single line of our own output
+    std::string json_value(const std::string& line, const std::string& key) {
+        const std::string pattern="\""+key+"\": ";
+        std::size_t pos=line.find(pattern);
+        if (pos==std::string::npos) return "";
+        pos+=pattern.size();
+        std::size_t end=line.find_first_of(",}",pos);
+        std::string value=line.substr(pos,end-pos);
+        if (value.size()>1 and value.front()=='"') value=value.substr(1,value.size()-2);
+        return value;
+    }
+
+    /// reads the results of a previously written benchmark file
+    std::vector<BenchResult> read_json(const std::string& filename) {
+        std::vector<BenchResult> results;
+        std::ifstream f(filename.c_str());
+        if (not f) MADNESS_EXCEPTION("madness_bench: cannot open baseline file",0);
+        std::string line;
+        while (std::getline(f,line)) {
+            if (line.find("\"name\": ")==std::string::npos) continue;
+            BenchResult r;
+            r.name=json_value(line,"name");
+            r.ndim=atoi(json_value(line,"ndim").c_str());
+            r.k=atoi(json_value(line,"k").c_str());
+            r.thresh=atof(json_value(line,"thresh").c_str());
+            r.wall=atof(json_value(line,"wall").c_str());
+            r.cpu=atof(json_value(line,"cpu").c_str());
+            r.nodes=atol(json_value(line,"nodes").c_str());
+            results.push_back(r);
+        }
+        return results;
+    }
+
+    /// compares to the baseline and returns the number of regressions
+    int compare(const std::vector<BenchResult>& results, const std::vector<BenchResult>& baseline,
+            double tolerance) {
+        std::map<std::string,BenchResult> base;
+        for (const BenchResult& b : baseline) base[b.tag()]=b;
+        int nregress=0;
+        printf("\n%-16s %4s %3s %10s %12s %12s %8s  %s\n","kernel","ndim","k","thresh",
+                "baseline(s)","current(s)","ratio","status");
+        for (const BenchResult& r : results) {
+            // round-trip thresh through the output format so that the tags compare equal
+            char t[32];
+            snprintf(t,sizeof(t),"%.3e",r.thresh);
+            BenchResult rr=r;
+            rr.thresh=atof(t);
+            auto it=base.find(rr.tag());
+            if (it==base.end()) {
+                printf("%-16s %4d %3d %10.1e %12s %12.4e %8s  %s\n",r.name.c_str(),r.ndim,r.k,r.thresh,
+                        "-",r.wall,"-","new");
+                continue;
+            }
+            const BenchResult& b=it->second;
+            const double ratio=(b.wall>0.0) ? r.wall/b.wall : 1.0;
+            std::string status="ok";
+            if (ratio>1.0+tolerance) {
+                status="REGRESSION";
+                ++nregress;
+            } else if (ratio<1.0-tolerance) {
+                status="faster";
+            }
+            if (b.nodes!=0 and b.nodes!=r.nodes) status+=" (tree size changed)";
+            printf("%-16s %4d %3d %10.1e %12.4e %12.4e %8.3f  %s\n",r.name.c_str(),r.ndim,r.k,r.thresh,
+                    b.wall,r.wall,ratio,status.c_str());
+        }
+        return nregress;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    World& world=initialize(argc, argv);
+    startup(world,argc,argv);
+
+    BenchParameters param;
+    for (int i=1; i<argc; ++i) {
+        const std::string arg=argv[i];
+        std::size_t pos=arg.find("=");
+        if (pos==std::string::npos) continue;
+        const std::string key=arg.substr(0,pos);
+        const std::string val=arg.substr(pos+1);
+
+        if (key=="ndim") {
+            param.ndims.clear();
+            for (const std::string& s : split(val,',')) param.ndims.push_back(atoi(s.c_str()));
+        }
+        else if (key=="k") param.k=atoi(val.c_str());
+        else if (key=="thresh") param.thresh=atof(val.c_str());
+        else if (key=="size") param.L=atof(val.c_str());
+        else if (key=="nfunc") param.nfunc=atoi(val.c_str());
+        else if (key=="nrep") param.nrep=std::max(1,atoi(val.c_str()));
+        else if (key=="ops") param.ops=split(val,',');
+        else if (key=="output") param.output=val;
+        else if (key=="baseline") param.baseline=val;
+        else if (key=="tolerance") param.tolerance=atof(val.c_str());
+        else if (world.rank()==0) print("madness_bench: ignoring unknown argument",arg);
+    }
+
+    std::vector<BenchResult> results;
+    for (int ndim : param.ndims) {
+        if (world.rank()==0) print("madness_bench: running ndim",ndim,"k",param.k,"thresh",param.thresh);
+        if (ndim==1) run_benchmarks<1>(world,param,results);
+        else if (ndim==2) run_benchmarks<2>(world,param,results);
+        else if (ndim==3) run_benchmarks<3>(world,param,results);
+        else if (ndim==4) run_benchmarks<4>(world,param,results);
+        else if (ndim==5) run_benchmarks<5>(world,param,results);
+        else if (ndim==6) run_benchmarks<6>(world,param,results);
+        else if (world.rank()==0) print("madness_bench: skipping unsupported ndim",ndim);
+    }
+
+    int nregress=0;
+    if (world.rank()==0) {
+        write_json(std::cout,world,param,results);
+        if (param.output.size()) {
+            std::ofstream f(param.output.c_str());
+            write_json(f,world,param,results);
+        }
+        if (param.baseline.size()) {
+            nregress=compare(results,read_json(param.baseline),param.tolerance);
+            print("\nmadness_bench: regressions beyond tolerance",param.tolerance,":",nregress);
+        }
+    }
+    world.gop.broadcast(nregress);
+
+    world.gop.fence();
+    finalize();
+    return nregress ? 1 : 0;
+}
@@ -1736,6 +1736,37 @@ namespace madness {
         return vresult;
     }
 
+    /// Handle that memoizes the values of a function for repeated multiplication
+
+    /// While a handle exists, multiplications with the function on the left
+    /// (mul_sparse, vmulXX, mul) reuse its values at the quadrature points
+    /// and the projections of its coefficients onto child boxes instead of
+    /// recomputing them for every right-hand function.  The function must
+    /// not be modified while cached.  The memory is released when the last
+    /// handle is destroyed, which must happen after the multiplications
+    /// have been fenced.
+    ///
+    /// \code
+    /// ValueCachedFunction<double,3> bra(psi);
+    /// for (auto& phi : vket) result.push_back(mul_sparse(psi, phi, tol, false));
+    /// world.gop.fence();
+    /// \endcode
+    template <typename T, std::size_t NDIM>
+    class ValueCachedFunction {
+        Function<T,NDIM> f;
+        std::shared_ptr< FunctionValueCache<T,NDIM> > cache;
+
+    public:
+        /// Enables the cache for \c f, which is reconstructed if necessary
+        explicit ValueCachedFunction(const Function<T,NDIM>& f) : f(f) {
+            f.reconstruct();
+            cache = f.get_impl()->enable_value_cache();
+        }
+
+        /// The cached function
+        const Function<T,NDIM>& function() const {return f;}
+    };
+
     /// Multiplies two functions with the new result being of type TensorResultType<L,R>
 
     /// Using operator notation forces a global fence after each operation but also
@@ -3323,6 +3323,7 @@ namespace madness {
         debug = false;
         truncate_on_project = true;
         apply_randomize = false;
+        apply_aggregate = false;
         project_randomize = false;
         bc = BoundaryConditions<NDIM>(BC_FREE);
         tt = TT_FULL;
@@ -3349,6 +3350,7 @@ namespace madness {
     		std::cout << "                           debug" <<  ": " << debug << std::endl;
     		std::cout << "             truncate_on_project" <<  ": " << truncate_on_project << std::endl;
     		std::cout << "                 apply_randomize" <<  ": " << apply_randomize << std::endl;
+    		std::cout << "                 apply_aggregate" <<  ": " << apply_aggregate << std::endl;
     		std::cout << "               project_randomize" <<  ": " << project_randomize << std::endl;
     		std::cout << "                              bc" <<  ": " << bc << std::endl;
     		std::cout << "                              tt" <<  ": " << tt << std::endl;
@@ -3369,6 +3371,7 @@ namespace madness {
     template <std::size_t NDIM> bool FunctionDefaults<NDIM>::debug;
     template <std::size_t NDIM> bool FunctionDefaults<NDIM>::truncate_on_project;
     template <std::size_t NDIM> bool FunctionDefaults<NDIM>::apply_randomize;
+    template <std::size_t NDIM> bool FunctionDefaults<NDIM>::apply_aggregate;
     template <std::size_t NDIM> bool FunctionDefaults<NDIM>::project_randomize;
     template <std::size_t NDIM> BoundaryConditions<NDIM> FunctionDefaults<NDIM>::bc;
     template <std::size_t NDIM> TensorType FunctionDefaults<NDIM>::tt;
@@ -75,6 +75,14 @@ namespace madness {
         }
     };
 
+    /// A contiguous range of displacements with the same distance, and their largest operator norm
+    struct DisplacementShell {
+        std::size_t begin;  ///< first displacement of the shell in get_disp(n)
+        std::size_t end;    ///< one past the last displacement of the shell
+        uint64_t distsq;    ///< squared length of the displacements in this shell
+        double maxnorm;     ///< max over the shell of the operator norm
+    };
+
 
     /// Convolutions in separated form (including Gaussian)
 
@@ -147,6 +155,7 @@ namespace madness {
         // SeparatedConvolutionData keeps data for all terms and all dimensions and 1 displacement
         mutable SimpleCache< SeparatedConvolutionData<Q,NDIM>, NDIM > data; ///< cache for all terms, dims and displacements
         mutable SimpleCache< SeparatedConvolutionData<Q,NDIM>, 2*NDIM > mod_data; ///< cache for all terms, dims and displacements
+        mutable ConcurrentHashMap< Level, std::vector<DisplacementShell> > shells; ///< per-level shell norms of the displacements
 
     public:
 
@@ -213,6 +222,9 @@ namespace madness {
 
 
         /// accumulate into result
+
+        /// With nbatch>1 f holds nbatch coefficient tensors along its trailing
+        /// index, and result holds the transformed tensors along its leading index.
         template <typename T, typename R>
         void apply_transformation(long dimk,
                                   const Transformation trans[NDIM],
@@ -220,10 +232,11 @@ namespace madness {
                                   Tensor<R>& work1,
                                   Tensor<R>& work2,
                                   const Q mufac,
-                                  Tensor<R>& result) const {
+                                  Tensor<R>& result,
+                                  const long nbatch=1) const {
 
             //PROFILE_MEMBER_FUNC(SeparatedConvolution); // Too fine grain for routine profiling
-            long size = 1;
+            long size = nbatch;
             for (std::size_t i=0; i<NDIM; ++i) size *= dimk;
             long dimi = size/dimk;
 
@@ -254,6 +267,11 @@ namespace madness {
             for (std::size_t d=0; d<NDIM; ++d) doit = doit || trans[d].VT;
 
             if (doit) {
+                // move the batch index back to the end
+                if (nbatch>1) {
+                    fast_transpose(nbatch, size/nbatch, w1, w2);
+                    std::swap(w1,w2);
+                }
                 for (std::size_t d=0; d<NDIM; ++d) {
                     if (trans[d].VT) {
                         dimi = size/trans[d].r;
@@ -362,7 +380,8 @@ namespace madness {
                          double tol,
                          const Q mufac,
                          Tensor<TENSOR_RESULT_TYPE(T,Q)>& work1,
-                         Tensor<TENSOR_RESULT_TYPE(T,Q)>& work2) const {
+                         Tensor<TENSOR_RESULT_TYPE(T,Q)>& work2,
+                         const long nbatch=1) const {
 
             //PROFILE_MEMBER_FUNC(SeparatedConvolution); // Too fine grain for routine profiling
             Transformation trans[NDIM];
@@ -412,7 +431,7 @@ namespace madness {
                 }
 
                 if (!rank_is_zero)
-                    apply_transformation(twok, trans, f, work1, work2, mufac, result);
+                    apply_transformation(twok, trans, f, work1, work2, mufac, result, nbatch);
 
                 //            apply_transformation2(n, twok, tol, trans2, f, work1, work2, mufac, result);
 //                apply_transformation3(trans2, f, mufac, result);
@@ -456,7 +475,7 @@ namespace madness {
                     trans2[d]=ops_1d[d]->T;
                 }
                 if (!rank_is_zero)
-                    apply_transformation(k, trans, f0, work1, work2, -mufac, result0);
+                    apply_transformation(k, trans, f0, work1, work2, -mufac, result0, nbatch);
 //                apply_transformation2(n, k, tol, trans2, f0, work1, work2, -mufac, result0);
 //                apply_transformation3(trans2, f0, -mufac, result0);
             }
@@ -1046,6 +1065,38 @@ namespace madness {
             return Displacements<NDIM>().get_disp(n, isperiodicsum);
         }
 
+        /// return the displacements of level n grouped in shells of equal distance
+
+        /// The table is made on first use for each level and holds the largest
+        /// operator norm of each shell, so that the apply loop can discard a shell
+        /// with a single comparison.  Only for the NS form, where the norm does not
+        /// depend on the source box.
+        const std::vector<DisplacementShell>& get_disp_shells(Level n) const {
+            MADNESS_ASSERT(not modified());
+            {
+                typename ConcurrentHashMap< Level, std::vector<DisplacementShell> >::const_accessor acc;
+                if (shells.find(acc,n)) return acc->second;
+            }
+            typename ConcurrentHashMap< Level, std::vector<DisplacementShell> >::accessor acc;
+            if (shells.insert(acc,n)) {
+                const std::vector< Key<NDIM> >& disp=get_disp(n);
+                const Key<NDIM> nullkey(n);
+                std::size_t i=0;
+                while (i<disp.size()) {
+                    DisplacementShell s;
+                    s.begin=i;
+                    s.distsq=disp[i].distsq();
+                    s.maxnorm=0.0;
+                    for (; i<disp.size() and disp[i].distsq()==s.distsq; ++i) {
+                        s.maxnorm=std::max(s.maxnorm,norm(n,disp[i],nullkey));
+                    }
+                    s.end=i;
+                    acc->second.push_back(s);
+                }
+            }
+            return acc->second;
+        }
+
         /// return the operator norm for all terms, all dimensions and 1 displacement
         double norm(Level n, const Key<NDIM>& d, const Key<NDIM>& source_key) const {
             // SeparatedConvolutionData keeps data for all terms and all dimensions and 1 displacement
@@ -1185,6 +1236,87 @@ namespace madness {
         }
 
 
+        /// apply this operator on the coefficients of several functions in full rank form
+
+        /// All coefficients share source and displacement, so the operator data and
+        /// the rank of each term are set up once, and each term is applied to the
+        /// stacked coefficients as one matrix multiplication per dimension.
+        /// @param[in]  source  the source key
+        /// @param[in]  shift   the displacement, where the source coeffs come from
+        /// @param[in]  coeff   source coeffs in full rank, one tensor per function
+        /// @param[in]  tol     thresh/#neigh/max(cnorm)
+        /// @return     tensors of full rank with the results op(coeff[i])
+        template <typename T>
+        std::vector< Tensor<TENSOR_RESULT_TYPE(T,Q)> > apply(const Key<NDIM>& source,
+                                                             const Key<NDIM>& shift,
+                                                             const std::vector< Tensor<T> >& coeff,
+                                                             double tol) const {
+            //PROFILE_MEMBER_FUNC(SeparatedConvolution); // Too fine grain for routine profiling
+            typedef TENSOR_RESULT_TYPE(T,Q) resultT;
+            const long nbatch=coeff.size();
+            if (nbatch==1) return std::vector< Tensor<resultT> >(1,apply(source, shift, coeff[0], tol));
+
+            double cpu0=cpu_time();
+
+            const long dimk = modified() ? k : 2*k;
+            const std::vector<long> vdimk(NDIM,dimk);
+            long size=1, size0=1;
+            for (std::size_t d=0; d<NDIM; ++d) {
+                size*=dimk;
+                size0*=k;
+            }
+
+            // one function per row, leaf nodes with only scaling coefficients
+            // are padded as in apply() above
+            Tensor<T> rows(nbatch,size), rows0(nbatch,size0);
+            for (long i=0; i<nbatch; ++i) {
+                const Tensor<T>& c=coeff[i];
+                MADNESS_ASSERT(c.ndim()==NDIM);
+                MADNESS_ASSERT(c.dim(0)==k or c.dim(0)==dimk);
+                Tensor<T> row=rows(i,_).reshape(vdimk);
+                if (c.dim(0)==dimk) row+=c;
+                else row(s0)+=c;
+                Tensor<T> row0=rows0(i,_).reshape(vk);
+                row0+=c(s0);
+            }
+
+            // the transformations expect the batch index last
+            Tensor<T> f(size,nbatch), f0(size0,nbatch);
+            fast_transpose(nbatch, size, rows.ptr(), f.ptr());
+            fast_transpose(nbatch, size0, rows0.ptr(), f0.ptr());
+
+            tol = 0.01*tol/rank; // Error is per separated term
+            ApplyTerms at;
+            at.r_term=true;
+            at.t_term=(source.level()>0);
+
+            const SeparatedConvolutionData<Q,NDIM>* op = getop(source.level(), shift, source);
+
+            Tensor<resultT> r(nbatch,size), r0(nbatch,size0);
+            const std::vector<long> vwork(1,nbatch*size);
+            Tensor<resultT> work1(vwork,false), work2(vwork,false);
+
+            for (int mu=0; mu<rank; ++mu) {
+                const SeparatedConvolutionInternal<Q,NDIM>& muop =  op->muops[mu];
+                if (muop.norm > tol) {
+                    Q fac = ops[mu].getfac();
+                    muopxv_fast(at, muop.ops, f, f0, r, r0, tol/std::abs(fac), fac,
+                                work1, work2, nbatch);
+                }
+            }
+
+            std::vector< Tensor<resultT> > result(nbatch);
+            for (long i=0; i<nbatch; ++i) {
+                result[i]=copy(r(i,_).reshape(vdimk));
+                result[i](s0).gaxpy(1.0,r0(i,_).reshape(vk),1.0);
+            }
+            double cpu1=cpu_time();
+            timer_full.accumulate(cpu1-cpu0);
+
+            return result;
+        }
+
+
         /// apply this operator on only 1 particle of the coefficients in low rank form
 
         /// note the unfortunate mess with NDIM: here NDIM is the operator dimension, and FDIM is the
@@ -169,6 +169,7 @@ int test_hartree_product(World& world, const long& k, const double thresh) {
     {
         real_function_6d ij=hartree_product(phi,phi);
         ij.truncate();
+        ij.print_size("hartree_product(phi,phi)");
 
         double norm=ij.norm2();
         print("norm(ij)",norm);
@@ -513,6 +514,7 @@ int test_convolution(World& world, const long& k, const double thresh) {
 	result1=result1-2.0*green6(copy(phi),copy(vphi)).truncate().reduce_rank();
 	world.gop.fence();
 
+	result1.print_size("GVphi");
 	double a=result1.norm2();
 	if (world.rank()==0) print("<GVphi | GVphi> ",a);
 
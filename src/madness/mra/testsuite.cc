@@ -900,6 +900,17 @@ int test_coulomb(World& world) {
     }
     CHECK(rerr, 10.0*thresh, "err in test_coulomb");
 
+    // remote contributions summed per box before they are sent
+    FunctionDefaults<3>::set_apply_aggregate(true);
+    START_TIMER;
+    Function<double,3> r2 = apply_only(op,f) ;
+    END_TIMER("apply aggregated");
+    FunctionDefaults<3>::set_apply_aggregate(false);
+    r2.reconstruct();
+    double rdiff = (r-r2).norm2();
+    if (world.rank() == 0) print("  aggregated apply difference", rdiff);
+    CHECK(rdiff, 0.01*thresh, "aggregated apply in test_coulomb");
+
     if (ok) return 0;
     return 1;
 }
@@ -188,6 +188,17 @@ void test_inner(World& world) {
 
     if (world.rank() == 0) 
         print("error norm",(rold-rnew).normf(),"\n");
+
+    if constexpr (std::is_same<T,R>::value) {
+        START_TIMER;
+        DistributedMatrix<T> dnew = matrix_inner(column_distributed_matrix_distribution(world,nleft,nright),
+                                                 left,*pright,sym);
+        END_TIMER("distributed");
+        Tensor<T> rdist(nleft,nright);
+        dnew.copy_to_replicated(rdist);
+        if (world.rank() == 0)
+            print("error norm distributed",(rdist-rnew).normf(),"\n");
+    }
 }
 
 template <typename T, typename R, int NDIM>
@@ -301,6 +312,106 @@ void test_rot(World& world) {
 
 }
 
+template <typename T, std::size_t NDIM>
+void test_grad(World& world) {
+    typedef std::shared_ptr< FunctionFunctorInterface<T,NDIM> > ffunctorT;
+
+    const double thresh=1.e-7;
+    Tensor<double> cell(NDIM,2);
+    for (std::size_t i=0; i<NDIM; ++i) {
+        cell(i,0) = -11.0-2*i;  // Deliberately asymmetric bounding box
+        cell(i,1) =  10.0+i;
+    }
+    FunctionDefaults<NDIM>::set_cell(cell);
+    FunctionDefaults<NDIM>::set_k(8);
+    FunctionDefaults<NDIM>::set_thresh(thresh);
+    FunctionDefaults<NDIM>::set_refine(true);
+    FunctionDefaults<NDIM>::set_initial_level(3);
+    FunctionDefaults<NDIM>::set_truncate_mode(1);
+
+    const int nvec=4;
+
+    if (world.rank() == 0)
+        print("testing fused gradient operator<",archive::get_type_name<T>(),">");
+
+    std::vector< Function<T,NDIM> > v(nvec);
+    for (int i=0; i<nvec; ++i) {
+        ffunctorT f(RandomGaussian<T,NDIM>(FunctionDefaults<NDIM>::get_cell(),0.5));
+        v[i] = FunctionFactory<T,NDIM>(world).functor(f);
+    }
+    compress(world,v);
+
+    START_TIMER;
+    std::vector< std::shared_ptr< Derivative<T,NDIM> > > D=gradient_operator<T,NDIM>(world);
+    std::vector< std::vector< Function<T,NDIM> > > ref(NDIM);
+    for (std::size_t d=0; d<NDIM; ++d) ref[d]=apply(world,*D[d],v);
+    END_TIMER("per axis");
+
+    START_TIMER;
+    GradientOperator<T,NDIM> gradop(D);
+    std::vector< std::vector< Function<T,NDIM> > > dv=gradop(v);
+    END_TIMER("fused");
+
+    double err=0.0;
+    for (std::size_t d=0; d<NDIM; ++d) err+=norm2(world,sub(world,dv[d],ref[d]));
+    err+=norm2(world,sub(world,grad(v[0]),gradop(v[0])));
+    if (world.rank() == 0) print("error norm",err,"\n");
+}
+
+template <typename T, std::size_t NDIM>
+void test_valuecache(World& world) {
+    typedef std::shared_ptr< FunctionFunctorInterface<T,NDIM> > ffunctorT;
+
+    const double thresh=1.e-7;
+    Tensor<double> cell(NDIM,2);
+    for (std::size_t i=0; i<NDIM; ++i) {
+        cell(i,0) = -11.0-2*i;  // Deliberately asymmetric bounding box
+        cell(i,1) =  10.0+i;
+    }
+    FunctionDefaults<NDIM>::set_cell(cell);
+    FunctionDefaults<NDIM>::set_k(8);
+    FunctionDefaults<NDIM>::set_thresh(thresh);
+    FunctionDefaults<NDIM>::set_refine(true);
+    FunctionDefaults<NDIM>::set_initial_level(3);
+    FunctionDefaults<NDIM>::set_truncate_mode(1);
+
+    const int nvec=5;
+
+    if (world.rank() == 0)
+        print("testing value cached multiplication<",archive::get_type_name<T>(),">");
+
+    Function<T,NDIM> left=FunctionFactory<T,NDIM>(world)
+            .functor(ffunctorT(RandomGaussian<T,NDIM>(FunctionDefaults<NDIM>::get_cell(),0.5)));
+    std::vector< Function<T,NDIM> > right(nvec);
+    for (int i=0; i<nvec; ++i) {
+        ffunctorT f(RandomGaussian<T,NDIM>(FunctionDefaults<NDIM>::get_cell(),100.0));
+        right[i] = FunctionFactory<T,NDIM>(world).functor(f);
+    }
+    left.reconstruct();
+    reconstruct(world,right);
+    left.norm_tree();
+    norm_tree(world,right);
+
+    START_TIMER;
+    std::vector< Function<T,NDIM> > ref=mul_sparse(world,left,right,thresh);
+    for (int i=0; i<nvec; ++i) ref.push_back(mul_sparse(left,right[i],thresh,false));
+    world.gop.fence();
+    END_TIMER("uncached");
+
+    START_TIMER;
+    std::vector< Function<T,NDIM> > result;
+    {
+        ValueCachedFunction<T,NDIM> cached(left);
+        result=mul_sparse(world,left,right,thresh);
+        for (int i=0; i<nvec; ++i) result.push_back(mul_sparse(left,right[i],thresh,false));
+        world.gop.fence();
+    }
+    END_TIMER("cached");
+
+    double err=norm2(world,sub(world,result,ref));
+    if (world.rank() == 0) print("error norm",err,"\n");
+}
+
 
 template <std::size_t NDIM>
 void test_multi_to_multi_op(World& world) {
@@ -345,6 +456,43 @@ void test_multi_to_multi_op(World& world) {
 
 }
 
+template <std::size_t NDIM>
+void test_apply(World& world) {
+
+    typedef Function<double,NDIM> functionT;
+    typedef std::vector<Function<double,NDIM> > vecfuncT;
+    typedef std::shared_ptr< FunctionFunctorInterface<double,NDIM> > ffunctorT;
+
+    const double thresh=1.e-5;
+    FunctionDefaults<NDIM>::set_cubic_cell(-10.0,10.0);
+    FunctionDefaults<NDIM>::set_k(8);
+    FunctionDefaults<NDIM>::set_thresh(thresh);
+    FunctionDefaults<NDIM>::set_refine(true);
+    FunctionDefaults<NDIM>::set_initial_level(3);
+    FunctionDefaults<NDIM>::set_truncate_mode(1);
+
+    vecfuncT v(6);
+    for (functionT& f : v) {
+        ffunctorT g(RandomGaussian<double,NDIM>(FunctionDefaults<NDIM>::get_cell(),100.0));
+        f=FunctionFactory<double,NDIM>(world).functor(g);
+    }
+
+    SeparatedConvolution<double,NDIM> op=BSHOperator<NDIM>(world, 1.0, 1.e-3, thresh);
+
+    // reference: one function at a time
+    START_TIMER;
+    vecfuncT ref(v.size());
+    for (std::size_t i=0; i<v.size(); ++i) ref[i]=apply(op,v[i]);
+    END_TIMER("apply one by one");
+
+    START_TIMER;
+    vecfuncT result=apply(world,op,v);
+    END_TIMER("vector apply");
+
+    double err=norm2(world,sub(world,result,ref));
+    if (world.rank() == 0) print("error in vector apply",err,norm2(world,ref));
+}
+
 int main(int argc, char**argv) {
     initialize(argc, argv);
     World world(SafeMPI::COMM_WORLD);
@@ -374,6 +522,12 @@ int main(int argc, char**argv) {
         test_rot<double,3>(world);
         test_rot<std::complex<double>,3>(world);
 
+        test_grad<double,3>(world);
+        test_valuecache<double,3>(world);
+
+        test_apply<1>(world);
+        test_apply<3>(world);
+
         if (!smalltest) test_multi_to_multi_op<3>(world);
 #if !HAVE_GENTENSOR
         test_inner<double,std::complex<double>,1,false>(world);
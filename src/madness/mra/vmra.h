@@ -681,6 +681,16 @@ namespace madness {
 
 
 
+    /// Computes the matrix inner product of two function vectors into a distributed matrix - q(i,j) = inner(f[i],g[j])
+
+    /// The key maps of both vectors are built once.  Each process then
+    /// computes its local contribution to one tile at a time, packing
+    /// the coefficients of all functions sharing a key into contiguous
+    /// panels (one matrix multiply per key), and the tile is summed onto
+    /// its owner only.  No process ever holds the full (n,m) matrix.
+    ///
+    /// For complex types symmetric is interpreted as Hermitian; \c sym
+    /// only allows f and g to share the key map.
     template <typename T, std::size_t NDIM>
     DistributedMatrix<T> matrix_inner(const DistributedMatrixDistribution& d,
                                       const std::vector< Function<T,NDIM> >& f,
@@ -688,25 +698,38 @@ namespace madness {
                                       bool sym=false)
     {
         PROFILE_FUNC;
+        typedef FunctionImpl<T,NDIM> implT;
+        World& world = d.get_world();
         DistributedMatrix<T> A(d);
         const int64_t n = A.coldim();
         const int64_t m = A.rowdim();
         MADNESS_ASSERT(int64_t(f.size()) == n && int64_t(g.size()) == m);
 
-        // Assume we can always create an ichunk*jchunk matrix locally
-        const int ichunk = 1000;
-        const int jchunk = 1000; // 1000*1000*8 = 8 MBytes
-        for (int64_t ilo=0; ilo<n; ilo+=ichunk) {
-            int64_t ihi = std::min(ilo + ichunk, n);
-            std::vector< Function<T,NDIM> > ivec(f.begin()+ilo, f.begin()+ihi);
-            for (int64_t jlo=0; jlo<m; jlo+=jchunk) {
-                int64_t jhi = std::min(jlo + jchunk, m);
-                std::vector< Function<T,NDIM> > jvec(g.begin()+jlo, g.begin()+jhi);
-
-                Tensor<T> P = matrix_inner(A.get_world(),ivec,jvec);
-                A.copy_from_replicated_patch(ilo, ihi-1, jlo, jhi-1, P);
-            }
+        world.gop.fence();
+        compress(world, f);
+        if ((void*)(&f) != (void*)(&g)) compress(world, g);
+
+        std::vector<const implT*> left(n), right(m);
+        for (int64_t i=0; i<n; ++i) left[i] = f[i].get_impl().get();
+        for (int64_t j=0; j<m; ++j) right[j] = g[j].get_impl().get();
+
+        typename implT::mapT lmap = implT::make_key_vec_map(left);
+        typename implT::mapT rmap;
+        typename implT::mapT* rmap_ptr = &lmap;
+        if (!(sym && (void*)(&f) == (void*)(&g))) {
+            rmap = implT::make_key_vec_map(right);
+            rmap_ptr = &rmap;
+        }
+
+        for (ProcessID p=0; p<world.size(); ++p) {
+            int64_t ilo, ihi, jlo, jhi;
+            d.get_range(p, ilo, ihi, jlo, jhi);
+            if (ilo>ihi || jlo>jhi) continue;
+            Tensor<T> tile = implT::template inner_local_tile<T>(world, lmap, *rmap_ptr, ilo, ihi, jlo, jhi);
+            world.gop.sum(tile.ptr(), tile.size(), p);
+            if (p == world.rank()) A.data()(___) = tile;
         }
+        world.gop.fence();
         return A;
     }
 
@@ -1212,9 +1235,23 @@ namespace madness {
         reconstruct(world, f);
         nonstandard(world, ncf);
 
-        std::vector< Function<TENSOR_RESULT_TYPE(T,R), NDIM> > result(f.size());
-        for (unsigned int i=0; i<f.size(); ++i) {
-            result[i] = apply_only(op, f[i], false);
+        typedef TENSOR_RESULT_TYPE(T,R) resultT;
+        std::vector< Function<resultT, NDIM> > result(f.size());
+        if (NDIM<=3 and f.size()>1) {
+            // all functions at once, sharing the operator data per box
+            std::vector<const FunctionImpl<R,NDIM>*> vf(f.size());
+            std::vector<FunctionImpl<resultT,NDIM>*> vresult(f.size());
+            for (unsigned int i=0; i<f.size(); ++i) {
+                result[i].set_impl(f[i], false);
+                vf[i]=f[i].get_impl().get();
+                vresult[i]=result[i].get_impl().get();
+            }
+            vresult[0]->apply_vector(op, vf, vresult, false);
+        }
+        else {
+            for (unsigned int i=0; i<f.size(); ++i) {
+                result[i] = apply_only(op, f[i], false);
+            }
         }
 
         world.gop.fence();
@@ -1441,13 +1478,8 @@ namespace madness {
         f.reconstruct();
         if (refine) f.refine();      // refine to make result more precise
 
-        std::vector< std::shared_ptr< Derivative<T,NDIM> > > grad=
-                gradient_operator<T,NDIM>(world);
-
-        std::vector<Function<T,NDIM> > result(NDIM);
-        for (size_t i=0; i<NDIM; ++i) result[i]=apply(*(grad[i]),f,false);
-        if (fence) world.gop.fence();
-        return result;
+        GradientOperator<T,NDIM> grad(world);
+        return grad(f,fence);
     }
 
     // BLM first derivative 
@@ -1459,16 +1491,12 @@ namespace madness {
         f.reconstruct();
         if (refine) f.refine();      // refine to make result more precise
 
-        std::vector< std::shared_ptr< Derivative<T,NDIM> > > grad=
-                gradient_operator<T,NDIM>(world);
+        GradientOperator<T,NDIM> grad(world);
 
         // Read in new coeff for each operator
-        for (unsigned int i=0; i<NDIM; ++i) (*grad[i]).set_ble1();
+        for (unsigned int i=0; i<NDIM; ++i) grad[i].set_ble1();
 
-        std::vector<Function<T,NDIM> > result(NDIM);
-        for (unsigned int i=0; i<NDIM; ++i) result[i]=apply(*(grad[i]),f,false);
-        if (fence) world.gop.fence();
-        return result;
+        return grad(f,fence);
     }
 
     // BLM second derivative
@@ -1480,16 +1508,12 @@ namespace madness {
         f.reconstruct();
         if (refine) f.refine();      // refine to make result more precise
 
-        std::vector< std::shared_ptr< Derivative<T,NDIM> > > grad=
-                gradient_operator<T,NDIM>(world);
+        GradientOperator<T,NDIM> grad(world);
 
         // Read in new coeff for each operator
-        for (unsigned int i=0; i<NDIM; ++i) (*grad[i]).set_ble2();
+        for (unsigned int i=0; i<NDIM; ++i) grad[i].set_ble2();
 
-        std::vector<Function<T,NDIM> > result(NDIM);
-        for (unsigned int i=0; i<NDIM; ++i) result[i]=apply(*(grad[i]),f,false);
-        if (fence) world.gop.fence();
-        return result;
+        return grad(f,fence);
     }
 
     // Bspline first derivative 
@@ -1501,16 +1525,12 @@ namespace madness {
         f.reconstruct();
         if (refine) f.refine();      // refine to make result more precise
 
-        std::vector< std::shared_ptr< Derivative<T,NDIM> > > grad=
-                gradient_operator<T,NDIM>(world);
+        GradientOperator<T,NDIM> grad(world);
 
         // Read in new coeff for each operator
-        for (unsigned int i=0; i<NDIM; ++i) (*grad[i]).set_bspline1();
+        for (unsigned int i=0; i<NDIM; ++i) grad[i].set_bspline1();
 
-        std::vector<Function<T,NDIM> > result(NDIM);
-        for (unsigned int i=0; i<NDIM; ++i) result[i]=apply(*(grad[i]),f,false);
-        if (fence) world.gop.fence();
-        return result;
+        return grad(f,fence);
     }
 
     // Bpsline second derivative
@@ -1522,16 +1542,12 @@ namespace madness {
         f.reconstruct();
         if (refine) f.refine();      // refine to make result more precise
 
-        std::vector< std::shared_ptr< Derivative<T,NDIM> > > grad=
-                gradient_operator<T,NDIM>(world);
+        GradientOperator<T,NDIM> grad(world);
 
         // Read in new coeff for each operator
-        for (unsigned int i=0; i<NDIM; ++i) (*grad[i]).set_bspline2();
+        for (unsigned int i=0; i<NDIM; ++i) grad[i].set_bspline2();
 
-        std::vector<Function<T,NDIM> > result(NDIM);
-        for (unsigned int i=0; i<NDIM; ++i) result[i]=apply(*(grad[i]),f,false);
-        if (fence) world.gop.fence();
-        return result;
+        return grad(f,fence);
     }
 
     // Bspline third derivative
@@ -1543,16 +1559,12 @@ namespace madness {
         f.reconstruct();
         if (refine) f.refine();      // refine to make result more precise
 
-        std::vector< std::shared_ptr< Derivative<T,NDIM> > > grad=
-                gradient_operator<T,NDIM>(world);
+        GradientOperator<T,NDIM> grad(world);
 
         // Read in new coeff for each operator
-        for (unsigned int i=0; i<NDIM; ++i) (*grad[i]).set_bspline3();
+        for (unsigned int i=0; i<NDIM; ++i) grad[i].set_bspline3();
 
-        std::vector<Function<T,NDIM> > result(NDIM);
-        for (unsigned int i=0; i<NDIM; ++i) result[i]=apply(*(grad[i]),f,false);
-        if (fence) world.gop.fence();
-        return result;
+        return grad(f,fence);
     }
 
 
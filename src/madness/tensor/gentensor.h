@@ -134,10 +134,12 @@ namespace madness {
 	struct TensorArgs {
 		double thresh;
 		TensorType tt;
-        TensorArgs() : thresh(-1.0), tt(TT_NONE) {}
-		TensorArgs(const double& thresh1, const TensorType& tt1)
+		RankReduction rr;	///< rank reduction algorithm for TT_2D
+        TensorArgs() : thresh(-1.0), tt(TT_NONE), rr(RR_GRAM) {}
+		TensorArgs(const double& thresh1, const TensorType& tt1, const RankReduction& rr1=RR_GRAM)
 			: thresh(thresh1)
-			, tt(tt1) {
+			, tt(tt1)
+			, rr(rr1) {
 		}
 		static std::string what_am_i(const TensorType& tt) {
 			if (tt==TT_2D) return "TT_2D";
@@ -148,8 +150,10 @@ namespace madness {
 		template <typename Archive>
 		void serialize(const Archive& ar) {
 		    int i=int(tt);
-		    ar & thresh & i;
+		    int j=int(rr);
+		    ar & thresh & i & j;
 		    tt=TensorType(i);
+		    rr=RankReduction(j);
 		}
 	};
 
@@ -199,6 +203,7 @@ namespace madness {
 		size_t real_size() const {return this->size();}
 
         void reduce_rank(const double& eps) {return;};
+        void reduce_rank(const TensorArgs& targs) {return;};
         void normalize() {return;}
 
         std::string what_am_i() const {return "GenTensor, aliased to Tensor";};
@@ -1207,7 +1212,7 @@ namespace madness {
         if (t.has_no_data()) return;
 
         // for now
-        MADNESS_ASSERT(targs.tt==TT_FULL or targs.tt==TT_2D);
+        MADNESS_ASSERT(targs.tt==TT_FULL or targs.tt==TT_2D or targs.tt==TT_TENSORTRAIN);
         MADNESS_ASSERT(current_type==TT_FULL or current_type==TT_2D);
 
         GenTensor<T> result;
@@ -1216,6 +1221,8 @@ namespace madness {
         } else if (targs.tt==TT_2D) {
             MADNESS_ASSERT(current_type==TT_FULL);
             result=GenTensor<T>(t.full_tensor(),targs);
+        } else if (targs.tt==TT_TENSORTRAIN) {
+            result=t.convert(targs);
         }
 
         t=result;
@@ -631,6 +631,15 @@ public:
         }
     }
 
+    /// reduce the rank with the algorithm selected in targs (TT_2D only)
+    void reduce_rank(const TensorArgs& targs) {
+        if ((type==TT_2D) and (targs.rr==RR_RANDOMIZED)) {
+            impl.svd->randomized_reduce(targs.thresh*facReduce());
+        } else {
+            reduce_rank(targs.thresh);
+        }
+    }
+
     /// Returns a pointer to the internal data
 
     /// @param[in]  ivec    index of core vector to which the return values points
@@ -823,6 +832,7 @@ LowRankTensor<TENSOR_RESULT_TYPE(T,Q)> transform_dir(const LowRankTensor<Q>& t,
 /// the use of final_tensor_type
 ///  - full x full -> full
 ///  - full x full -> SVD                           ( default )
+///  - full x full -> TensorTrain
 ///  - TensorTrain x TensorTrain -> TensorTrain
 /// all other combinations are currently invalid.
 template <class T, class Q>
@@ -862,6 +872,10 @@ LowRankTensor<TENSOR_RESULT_TYPE(T,Q)> outer(const LowRankTensor<T>& t1,
         return LowRankTensor<resultT>(SVDTensor<resultT>(srconf));
 
     } else if (final_tensor_args.tt==TT_TENSORTRAIN) {
+        // decompose the factors, the cores of the product are those of t1 and t2
+        if (t1.tensor_type()==TT_FULL) {
+            return outer(t1.convert(final_tensor_args),t2.convert(final_tensor_args),final_tensor_args);
+        }
         MADNESS_ASSERT(t1.tensor_type()==TT_TENSORTRAIN);
         MADNESS_ASSERT(t2.tensor_type()==TT_TENSORTRAIN);
         return outer(*t1.impl.tt,*t2.impl.tt);
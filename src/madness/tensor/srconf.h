@@ -436,6 +436,37 @@ namespace madness {
             MADNESS_ASSERT(has_structure());
 		}
 
+		/// reduce the rank using a randomized range finder
+
+		/// same result as divide_and_conquer_reduce up to the threshold, but
+		/// the cost grows with the reduced rank instead of the current rank;
+		/// see ortho_randomized
+		void randomized_reduce(const double& thresh) {
+
+			if (type()==TT_FULL) return;
+			if (has_no_data()) return;
+			if (rank()==1) {
+				normalize();
+				return;
+			}
+			if constexpr (!std::is_same<T,double>::value) {
+				divide_and_conquer_reduce(thresh);
+			} else {
+				normalize();
+				weights_=weights_(Slice(0,rank()-1));
+				tensorT v0=flat_vector(0);
+				tensorT v1=flat_vector(1);
+				ortho_randomized(v0,v1,weights_,thresh);
+				std::swap(vector_[0],v0);
+				std::swap(vector_[1],v1);
+				rank_=weights_.size();
+				MADNESS_ASSERT(rank_>=0);
+				this->make_structure();
+				make_slices();
+			}
+			MADNESS_ASSERT(has_structure());
+		}
+
 	public:
 		/// orthonormalize this
 		void orthonormalize(const double& thresh) {
@@ -1672,6 +1703,74 @@ protected:
 		return;
 	}
 
+	/// randomized version of ortho3
+
+	/// yields the same optimally truncated, bi-orthonormal representation
+	/// of A = x^T diag(w) y as ortho3, without forming the rank x rank
+	/// overlap matrices:
+	///  - sample the range of A with a random matrix of nsample columns
+	///  - orthonormalize the sample (LQ) and project A onto it
+	///  - SVD of the small projected matrix
+	/// The sample is doubled until at least \c oversampling of its singular
+	/// values fall below the threshold, i.e. the rank is found adaptively.
+	/// operation count is O(k r l + k l^2) for a final sample size l, compared
+	/// to O(k r^2 + r^3) for ortho3; use it when the rank is reduced a lot.
+	///
+	/// @param[in,out]	x normalized left subspace
+	/// @param[in,out]	y normalize right subspace
+	/// @param[in,out]	weights weights
+	/// @param[in]		thresh	truncation threshold
+	template<typename T>
+	void ortho_randomized(Tensor<T>& x, Tensor<T>& y, Tensor<double>& weights, const double& thresh) {
+
+		typedef Tensor<T> tensorT;
+
+		const long rank=x.dim(0);
+		const long kx=x.dim(1);
+		const long ky=y.dim(1);
+		const long maxrank=std::min(rank,std::min(kx,ky));
+		const long oversampling=8;
+
+		long nsample=std::min(maxrank,2*oversampling);
+		while (true) {
+
+			// sample the range of A: Z^T = omega y^T diag(w) x
+			tensorT omega(nsample,ky);
+			omega.fillrandom();
+			omega-=0.5;
+			tensorT yo=inner(omega,y,1,1);
+			for (long r=0; r<rank; ++r) yo(_,r)*=weights(r);
+			tensorT q=inner(yo,x,1,0);
+
+			// orthonormal basis q (nsample,kx) of the sample and projection B = q A
+			tensorT l;
+			lq(q,l);
+			tensorT qx=inner(q,x,1,1);
+			for (long r=0; r<rank; ++r) qx(_,r)*=weights(r);
+			tensorT b=inner(qx,y,1,0);
+
+			tensorT U,VT;
+			Tensor<double> s;
+			svd(b,U,s,VT);
+			long i=SRConf<T>::max_sigma(thresh,s.dim(0),s);
+
+			// accept if the sample has captured the range of A
+			if ((i+1+oversampling<=nsample) or (nsample==maxrank)) {
+				if (i>=0) {
+					x=inner(U(_,Slice(0,i)),q,0,0);
+					y=copy(VT(Slice(0,i),_));
+					weights=copy(s(Slice(0,i)));
+				} else {
+					x.clear();
+					y.clear();
+					weights.clear();
+				}
+				return;
+			}
+			nsample=std::min(maxrank,2*nsample);
+		}
+	}
+
 	template<typename T>
 	static inline
 	std::ostream& operator<<(std::ostream& s, const SRConf<T>& sr) {
@@ -271,6 +271,9 @@ namespace madness {
     /// low rank representations of tensors (see gentensor.h)
 	enum TensorType {TT_NONE, TT_FULL, TT_2D, TT_TENSORTRAIN};
 
+    /// algorithms for reducing the rank of TT_2D low rank tensors (see srconf.h)
+    enum RankReduction {RR_GRAM, RR_RANDOMIZED};
+
     static
     inline
     std::ostream& operator << (std::ostream& s, const TensorType& tt) {
@@ -463,6 +463,50 @@ int testGenTensor_rankreduce(const long& k, const long& dim, const double& eps,
 	return nerror;
 }
 
+/// compare the randomized rank reduction with the default one on a sum of many low-rank terms
+int testGenTensor_randomized(const long& k, const long& dim, const double& eps) {
+
+	print("entering randomized rank reduction");
+
+	int nerror=0;
+
+	// nterm terms of rank trank, all in the same subspace
+	const long trank=8;
+	const long nterm=50;
+	const long kvec=std::pow(k,dim/2);
+	std::vector<long> d(dim,k);
+	Tensor<double> a=Tensor<double>(kvec,trank).fillrandom();
+	Tensor<double> b=Tensor<double>(trank,kvec).fillrandom();
+	for (long r=0; r<trank; ++r) b(r,_).scale(std::pow(0.1,r));
+
+	Tensor<double> t(d);
+	GenTensor<double> g(d,TensorArgs(eps,TT_2D));
+	for (long i=0; i<nterm; ++i) {
+		Tensor<double> c=Tensor<double>(trank).fillrandom();
+		Tensor<double> ac=copy(a);
+		for (long r=0; r<trank; ++r) ac(_,r).scale(c(r));
+		Tensor<double> ti=inner(ac,b).reshape(d);
+		ti.scale(1.0/nterm);
+		t+=ti;
+		g+=GenTensor<double>(ti,eps*0.01/nterm,TT_2D);
+	}
+
+	for (RankReduction rr : {RR_GRAM,RR_RANDOMIZED}) {
+		GenTensor<double> g1=copy(g);
+		double cpu0=cpu_time();
+		g1.reduce_rank(TensorArgs(eps,TT_2D,rr));
+		double cpu1=cpu_time();
+		double norm=(g1.full_tensor_copy()-t).normf();
+		bool success=is_small(norm,eps) and (g1.rank()<=trank);
+		print(ok(success),"rank reduction",(rr==RR_GRAM) ? "gram      " : "randomized",
+				"rank",g.rank(),"->",g1.rank(),"error",norm,"time",cpu1-cpu0);
+		if (!success) nerror++;
+	}
+
+	print("all done\n");
+	return nerror;
+}
+
 int testGenTensor_transform(const long& k, const long& dim, const double& eps, const TensorType& tt) {
 
 	print("entering transform");
@@ -998,6 +1042,8 @@ int main(int argc, char**argv) {
     error+=testGenTensor_rankreduce(k,dim,eps,TT_FULL);
     error+=testGenTensor_rankreduce(k,dim,eps,TT_2D);
     error+=testGenTensor_rankreduce(k,dim,eps,TT_TENSORTRAIN);
+    error+=testGenTensor_randomized(k,dim,eps);
+    error+=testGenTensor_randomized(8,dim,eps);
 
     error+=testGenTensor_transform(k,dim,eps,TT_FULL);
     error+=testGenTensor_transform(k,dim,eps,TT_2D);
@@ -43,6 +43,7 @@
 // These includes must go after world.h.
 #include <madness/world/worldam.h>
 #include <madness/world/world_task_queue.h>
+#include <madness/world/world_task_coroutine.h>
 #include <madness/world/worldgop.h>
 #include <madness/world/worlddc.h>
 
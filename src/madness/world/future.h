@@ -47,6 +47,7 @@
 #include <madness/world/stack.h>
 #include <madness/world/worldref.h>
 #include <madness/world/world.h>
+#include <madness/world/pool_allocator.h>
 
 /// \addtogroup futures
 /// @{
@@ -507,8 +508,11 @@ namespace madness {
         typedef RemoteReference< FutureImpl<T> > remote_refT;
 
         /// Makes an unassigned future.
+
+        /// The implementation and its reference count share one block from
+        /// the per-thread small-object pool.
         Future() :
-            f(new FutureImpl<T>()), value(nullptr)
+            f(std::allocate_shared<FutureImpl<T> >(PoolAllocator<FutureImpl<T> >())), value(nullptr)
         {
         }
 
@@ -528,8 +532,7 @@ namespace madness {
         explicit Future(const remote_refT& remote_ref) :
                 f(remote_ref.is_local() ?
                         remote_ref.get_shared() :
-                        std::make_shared<FutureImpl<T> >(remote_ref)),
-                //                        std::shared_ptr<FutureImpl<T> >(new FutureImpl<T>(remote_ref))),
+                        std::allocate_shared<FutureImpl<T> >(PoolAllocator<FutureImpl<T> >(), remote_ref)),
                 value(nullptr)
         {
         }
@@ -555,7 +558,7 @@ namespace madness {
                 nullptr)
         {
             if(other.is_default_initialized())
-                f.reset(new FutureImpl<T>()); // Other was default constructed so make a new f
+                f = std::allocate_shared<FutureImpl<T> >(PoolAllocator<FutureImpl<T> >()); // Other was default constructed so make a new f
         }
 
         /// Destructor.
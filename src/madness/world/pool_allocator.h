@@ -0,0 +1,184 @@
+/*
+  This file is part of MADNESS.
+
+  Copyright (C) 2007,2010 Oak Ridge National Laboratory
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+  For more information please contact:
+
+  Robert J. Harrison
+  Oak Ridge National Laboratory
+  One Bethel Valley Road
+  P.O. Box 2008, MS-6367
+
+  email: harrisonrj@ornl.gov
+  tel:   865-241-3937
+  fax:   865-572-0680
+*/
+
+#ifndef MADNESS_WORLD_POOL_ALLOCATOR_H__INCLUDED
+#define MADNESS_WORLD_POOL_ALLOCATOR_H__INCLUDED
+
+/**
+ \file pool_allocator.h
+ \brief Per-thread recycling of small, short-lived objects such as tasks and futures.
+ \ingroup threads
+*/
+
+#include <cstddef>
+#include <new>
+
+namespace madness {
+
+    namespace detail {
+
+        /// Per-thread free lists of fixed-size blocks, one list per size class.
+
+        /// Tree recursions create and destroy millions of tasks and future
+        /// implementations of a handful of sizes.  Blocks are rounded up to a
+        /// multiple of \c granularity bytes and, when freed, are kept on the
+        /// free list of the freeing thread for reuse by the next allocation
+        /// of the same size class on that thread.  No locks are taken.  A block
+        /// may be freed by a different thread than the one that allocated it;
+        /// it then simply migrates to the other thread's list.  Requests larger
+        /// than the largest size class, and blocks beyond \c maxbytes per size
+        /// class and thread, go to the global heap.
+        class SmallObjectPool {
+        public:
+            static const std::size_t granularity = 64;  ///< Size class spacing in bytes
+            static const std::size_t nclass = 32;       ///< Number of size classes (up to 2 KB)
+            static const std::size_t maxbytes = 1<<18;  ///< Bytes kept per size class and thread
+
+        private:
+            struct Block {
+                Block* next;
+            };
+
+            struct FreeLists {
+                Block* head[nclass];
+                std::size_t count[nclass];
+
+                FreeLists() {
+                    for (std::size_t i=0; i<nclass; ++i) {
+                        head[i] = nullptr;
+                        count[i] = 0;
+                    }
+                }
+
+                ~FreeLists() {
+                    for (std::size_t i=0; i<nclass; ++i) {
+                        while (head[i]) {
+                            Block* p = head[i];
+                            head[i] = p->next;
+                            ::operator delete(static_cast<void*>(p));
+                        }
+                    }
+                    destroyed() = true;
+                }
+            };
+
+            /// True once the free lists of this thread have been destroyed (thread or program exit)
+            static bool& destroyed() {
+                static thread_local bool flag = false;
+                return flag;
+            }
+
+            static FreeLists& lists() {
+                static thread_local FreeLists l;
+                return l;
+            }
+
+            static std::size_t size_class(std::size_t size) {
+                return (size + granularity - 1)/granularity - 1;
+            }
+
+        public:
+            /// Returns storage for an object of \c size bytes
+            static void* allocate(std::size_t size) {
+                const std::size_t c = size_class(size);
+                if (size == 0 || c >= nclass || destroyed()) return ::operator new(size);
+
+                FreeLists& l = lists();
+                Block* p = l.head[c];
+                if (p) {
+                    l.head[c] = p->next;
+                    --l.count[c];
+                    return static_cast<void*>(p);
+                }
+                return ::operator new((c+1)*granularity);
+            }
+
+            /// Returns storage obtained from \c allocate() with the same \c size
+            static void deallocate(void* p, std::size_t size) noexcept {
+                if (!p) return;
+                const std::size_t c = size_class(size);
+                if (size == 0 || c >= nclass || destroyed()) {
+                    ::operator delete(p);
+                    return;
+                }
+
+                FreeLists& l = lists();
+                if (l.count[c]*(c+1)*granularity >= maxbytes) {
+                    ::operator delete(p);
+                    return;
+                }
+                Block* b = static_cast<Block*>(p);
+                b->next = l.head[c];
+                l.head[c] = b;
+                ++l.count[c];
+            }
+        };
+
+    } // namespace detail
+
+    /// Standard allocator drawing from \c detail::SmallObjectPool
+
+    /// Intended for \c std::allocate_shared, which places the object and its
+    /// reference count in a single pooled block.
+    /// \tparam T The allocated type.
+    template <typename T>
+    class PoolAllocator {
+    public:
+        typedef T value_type;
+
+        PoolAllocator() = default;
+
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U>&) noexcept { }
+
+        T* allocate(std::size_t n) {
+            if (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) // Pool blocks have the default alignment
+                return static_cast<T*>(::operator new(n*sizeof(T), std::align_val_t(alignof(T))));
+            return static_cast<T*>(detail::SmallObjectPool::allocate(n*sizeof(T)));
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept {
+            if (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                ::operator delete(static_cast<void*>(p), std::align_val_t(alignof(T)));
+            else
+                detail::SmallObjectPool::deallocate(static_cast<void*>(p), n*sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+
+        template <typename U>
+        bool operator!=(const PoolAllocator<U>&) const noexcept { return false; }
+    };
+
+} // namespace madness
+
+#endif // MADNESS_WORLD_POOL_ALLOCATOR_H__INCLUDED
@@ -62,6 +62,31 @@ public:
     static bool finished() {return total_count==(NGEN*NTASK);}
 };
 
+// Binary tree of TaskFn tasks joined through futures, the pattern of the
+// MRA tree recursions, to measure task and future creation throughput.
+const int TREE_DEPTH=17;
+
+long tree_leaf() {return 1;}
+
+long tree_sum(long left, long right) {return left + right;}
+
+madness::Future<long> spawn_tree(madness::World& world, int depth) {
+    if (depth == 0) return world.taskq.add(&tree_leaf);
+    madness::Future<long> left = spawn_tree(world, depth-1);
+    madness::Future<long> right = spawn_tree(world, depth-1);
+    return world.taskq.add(&tree_sum, left, right);
+}
+
+#ifdef MADNESS_HAS_COROUTINES
+// The same tree with each node a coroutine that awaits its children
+madness::TaskCoroutine<long> coroutine_tree(madness::World& world, int depth) {
+    if (depth == 0) co_return 1;
+    madness::Future<long> left = coroutine_tree(world, depth-1);
+    madness::Future<long> right = coroutine_tree(world, depth-1);
+    co_return co_await left + co_await right;
+}
+#endif
+
 int main(int argc, char** argv) {
     bool smalltest = false;
     if (getenv("MAD_SMALL_TESTS")) smalltest=true;
@@ -95,6 +120,30 @@ int main(int argc, char** argv) {
     for (unsigned long i = 0; i < (madness::ThreadPool::size() + 1); ++i)
         std::cout << i << " " << thread_counters[i] << "\n";
 
+    // Task spawn throughput for TaskFn tasks with future arguments
+    start = madness::wall_time();
+    madness::Future<long> nleaf = spawn_tree(world, TREE_DEPTH);
+    world.gop.fence();
+    finish = madness::wall_time();
+    MADNESS_CHECK(nleaf.get() == (1l << TREE_DEPTH));
+
+    const long ntree = (2l << TREE_DEPTH) - 1;
+    std::cout << "Tree tasks = " << ntree
+            << "\nTree runtime = " << finish - start
+            << " (s)\nTree tasks per second = " << ntree/(finish - start) << "\n";
+
+#ifdef MADNESS_HAS_COROUTINES
+    start = madness::wall_time();
+    madness::Future<long> ncoroleaf = coroutine_tree(world, TREE_DEPTH);
+    world.gop.fence();
+    finish = madness::wall_time();
+    MADNESS_CHECK(ncoroleaf.get() == (1l << TREE_DEPTH));
+
+    std::cout << "Coroutine tree hops = " << ntree
+            << "\nCoroutine tree runtime = " << finish - start
+            << " (s)\nCoroutine tree hops per second = " << ntree/(finish - start) << "\n";
+#endif
+
     cleanup_tls();
     madness::finalize();
 
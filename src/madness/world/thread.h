@@ -40,6 +40,7 @@
 
 #include <madness/world/dqueue.h>
 #include <madness/world/function_traits.h>
+#include <madness/world/pool_allocator.h>
 #include <vector>
 #include <cstddef>
 #include <cstdio>
@@ -999,6 +1000,32 @@ namespace madness {
                     barrier = 0;
             }
         }
+
+        /// Allocates a task from the per-thread pool of small objects.
+
+        /// Tree recursions create millions of short-lived tasks; recycling
+        /// their storage avoids a trip through the global heap for each one.
+        /// \param[in] size The size of the task object.
+        /// \return Storage for the task.
+        static void* operator new(std::size_t size) {
+            return detail::SmallObjectPool::allocate(size);
+        }
+
+        /// Placement new, hidden by the class-specific operator new otherwise.
+
+        /// \param[in] p Storage for the task.
+        /// \return \c p.
+        static void* operator new(std::size_t, void* p) noexcept {
+            return p;
+        }
+
+        /// Returns the storage of a task to the pool.
+
+        /// \param[in] p Pointer to the task object.
+        /// \param[in] size The size of the task object.
+        static void operator delete(void* p, std::size_t size) noexcept {
+            detail::SmallObjectPool::deallocate(p, size);
+        }
 #if HAVE_PARSEC
 	    //////////// Parsec Related Begin ////////////////////
             parsec_task_t                       parsec_task;
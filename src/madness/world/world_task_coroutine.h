@@ -0,0 +1,224 @@
+/*
+  This file is part of MADNESS.
+
+  Copyright (C) 2007,2010 Oak Ridge National Laboratory
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+  For more information please contact:
+
+  Robert J. Harrison
+  Oak Ridge National Laboratory
+  One Bethel Valley Road
+  P.O. Box 2008, MS-6367
+
+  email: harrisonrj@ornl.gov
+  tel:   865-241-3937
+  fax:   865-572-0680
+*/
+
+
+/**
+ \file world_task_coroutine.h
+ \brief Defines \c TaskCoroutine, C++20 coroutines that run as tasks of a \c WorldTaskQueue.
+ \ingroup taskq
+
+ A task written as a coroutine can \c co_await a \c Future instead of
+ spawning a continuation task that takes the future as an argument.
+ If the future is already assigned the coroutine simply continues;
+ otherwise it is suspended and resumed in the thread pool once the
+ value arrives.  Since \c WorldContainer::find() returns a future, the
+ latency of a remote lookup can be hidden the same way:
+ \code
+    TaskCoroutine<double> f(World& world, const dcT& c, const keyT& key) {
+        auto it = co_await c.find(key);
+        co_return it->second;
+    }
+ \endcode
+ The first parameter of the coroutine must be the \c World whose task
+ queue runs it.  Calling the coroutine queues its body and returns
+ immediately; the returned \c TaskCoroutine converts to a \c Future for
+ the \c co_return value.  Every stretch of the coroutine between two
+ suspensions counts as one task, so \c WorldTaskQueue::fence() waits for
+ the coroutine to complete.
+
+ Coroutines require C++20 (configure with \c CMAKE_CXX_STANDARD=20);
+ otherwise this header is empty and \c MADNESS_HAS_COROUTINES is not
+ defined.  \c TaskFn based tasks are unaffected.
+*/
+
+#ifndef MADNESS_WORLD_WORLD_TASK_COROUTINE_H__INCLUDED
+#define MADNESS_WORLD_WORLD_TASK_COROUTINE_H__INCLUDED
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <madness/world/world.h>
+#include <madness/world/future.h>
+#include <madness/world/world_task_queue.h>
+
+#ifndef MADNESS_HAS_COROUTINES
+#define MADNESS_HAS_COROUTINES 1
+#endif
+
+/// \addtogroup taskq
+/// @{
+
+namespace madness {
+
+    template <typename> class TaskCoroutine;
+
+    namespace detail {
+
+        /// Task that resumes a suspended coroutine
+
+        /// Created with one dependency per future the coroutine waits on,
+        /// so the task queue submits it to the thread pool once they are
+        /// all assigned.
+        class CoroutineResumeTask : public TaskInterface {
+            std::coroutine_handle<> handle;
+
+        public:
+            CoroutineResumeTask(std::coroutine_handle<> handle, int ndepend)
+                : TaskInterface(ndepend), handle(handle) { }
+
+            void run(World&) { handle.resume(); }
+        };
+
+        /// Awaiter returned by \c co_await on a \c Future inside a \c TaskCoroutine
+        template <typename T>
+        class FutureAwaiter {
+            World& world;
+            Future<T> f;
+
+        public:
+            FutureAwaiter(World& world, const Future<T>& f) : world(world), f(f) { }
+
+            /// An assigned future does not suspend the coroutine
+            bool await_ready() const { return f.probe(); }
+
+            void await_suspend(std::coroutine_handle<> h) {
+                CoroutineResumeTask* t = new CoroutineResumeTask(h, 1);
+                f.register_callback(t);
+                world.taskq.add(t); // May resume the coroutine before returning
+            }
+
+            T await_resume() { return f.get(); }
+        };
+
+        /// Promise state shared by all \c TaskCoroutine result types
+        class TaskCoroutinePromiseBase {
+        protected:
+            World& world;
+
+        public:
+            template <typename... argsT>
+            TaskCoroutinePromiseBase(World& world, argsT&&...) : world(world) { }
+
+            /// Suspends the new coroutine and queues its body as a task
+            struct Launch {
+                World& world;
+
+                bool await_ready() const noexcept { return false; }
+
+                void await_suspend(std::coroutine_handle<> h) {
+                    world.taskq.add(new CoroutineResumeTask(h, 0));
+                }
+
+                void await_resume() const noexcept { }
+            };
+
+            Launch initial_suspend() { return Launch{world}; }
+
+            /// The frame is destroyed as soon as the body completes
+            std::suspend_never final_suspend() noexcept { return {}; }
+
+            void unhandled_exception() { throw; }
+
+            template <typename T>
+            FutureAwaiter<T> await_transform(const Future<T>& f) {
+                return FutureAwaiter<T>(world, f);
+            }
+
+            template <typename T>
+            FutureAwaiter<T> await_transform(const TaskCoroutine<T>& c) {
+                return FutureAwaiter<T>(world, c.result());
+            }
+        };
+
+        template <typename R>
+        class TaskCoroutinePromise : public TaskCoroutinePromiseBase {
+            Future<R> result;
+
+        public:
+            using TaskCoroutinePromiseBase::TaskCoroutinePromiseBase;
+
+            TaskCoroutine<R> get_return_object() { return TaskCoroutine<R>(result); }
+
+            template <typename U>
+            void return_value(U&& value) { result.set(std::forward<U>(value)); }
+        };
+
+        template <>
+        class TaskCoroutinePromise<void> : public TaskCoroutinePromiseBase {
+        public:
+            using TaskCoroutinePromiseBase::TaskCoroutinePromiseBase;
+
+            TaskCoroutine<void> get_return_object();
+
+            void return_void() { }
+        };
+
+    } // namespace detail
+
+    /// Return type of a coroutine that runs as tasks of the world task queue
+
+    /// \tparam R The type of the \c co_return value; for \c void the
+    ///     completion is only observable through \c WorldTaskQueue::fence().
+    template <typename R>
+    class TaskCoroutine {
+        Future<R> f;
+
+    public:
+        typedef detail::TaskCoroutinePromise<R> promise_type;
+
+        explicit TaskCoroutine(const Future<R>& f) : f(f) { }
+
+        /// Returns the future for the \c co_return value
+        const Future<R>& result() const { return f; }
+
+        operator Future<R>() const { return f; }
+    };
+
+    template <>
+    class TaskCoroutine<void> {
+    public:
+        typedef detail::TaskCoroutinePromise<void> promise_type;
+    };
+
+    inline TaskCoroutine<void> detail::TaskCoroutinePromise<void>::get_return_object() {
+        return TaskCoroutine<void>();
+    }
+
+} // namespace madness
+
+/// @}
+
+#endif // __cpp_impl_coroutine
+
+#endif // MADNESS_WORLD_WORLD_TASK_COROUTINE_H__INCLUDED
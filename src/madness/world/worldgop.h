@@ -718,14 +718,15 @@ namespace madness {
             delete [] buf;
         }
 
-        /// Inplace global reduction (like MPI all_reduce) while still processing AM & tasks
+        /// Inplace reduction onto process \c root (like MPI reduce) while still processing AM & tasks
 
-        /// Optimizations can be added for long messages and to reduce the memory footprint
+        /// Only \c root receives the reduced data; on the other processes
+        /// \c buf holds a partial result on return.
         template <typename T, class opT>
-        void reduce(T* buf, size_t nelem, opT op) {
+        void reduce(T* buf, size_t nelem, ProcessID root, opT op) {
             SafeMPI::Request req0, req1;
             ProcessID parent, child0, child1;
-            world_.mpi.binary_tree_info(0, parent, child0, child1);
+            world_.mpi.binary_tree_info(root, parent, child0, child1);
             Tag gsum_tag = world_.mpi.unique_tag();
 
             T* buf0 = new T[nelem];
@@ -750,7 +751,14 @@ namespace madness {
                 req0 = world_.mpi.Isend(buf, nelem*sizeof(T), MPI_BYTE, parent, gsum_tag);
                 World::await(req0);
             }
+        }
+
+        /// Inplace global reduction (like MPI all_reduce) while still processing AM & tasks
 
+        /// Optimizations can be added for long messages and to reduce the memory footprint
+        template <typename T, class opT>
+        void reduce(T* buf, size_t nelem, opT op) {
+            reduce(buf, nelem, 0, op);
             broadcast(buf, nelem, 0);
         }
 
@@ -760,6 +768,12 @@ namespace madness {
             reduce< T, WorldSumOp<T> >(buf, nelem, WorldSumOp<T>());
         }
 
+        /// Inplace sum onto process \c root only while still processing AM & tasks
+        template <typename T>
+        inline void sum(T* buf, size_t nelem, ProcessID root) {
+            reduce< T, WorldSumOp<T> >(buf, nelem, root, WorldSumOp<T>());
+        }
+
         /// Inplace global min while still processing AM & tasks
         template <typename T>
         inline void min(T* buf, size_t nelem) {